@@ -0,0 +1,173 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "AnalysisService.h"
+#include "SpectrumAnalysisWorker.h"
+
+//==============================================================================
+AnalysisService::FftPlan::FftPlan(int order)
+    : fft(order),
+      window(static_cast<size_t>(1 << order)),
+      size(1 << order)
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(),
+                                                              juce::dsp::WindowingFunction<float>::hann, true);
+}
+
+//==============================================================================
+// Thread do grupo: processa uma análise por vez até não haver trabalho e
+// então dorme até notifyWorkPending ou stopThread
+class AnalysisService::PoolThread : public juce::Thread
+{
+public:
+    PoolThread(AnalysisService& s, int index)
+        : juce::Thread("ParamEq Analysis " + juce::String(index + 1)), service(s) {}
+
+    ~PoolThread() override { stopThread(1000); }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            auto* worker = service.claimNextWorker();
+
+            if (worker == nullptr)
+            {
+                wait(-1);
+                continue;
+            }
+
+            worker->processPendingWork();
+            service.workerReleased(worker);
+        }
+    }
+
+private:
+    AnalysisService& service;
+};
+
+//==============================================================================
+AnalysisService::AnalysisService()
+{
+    // Poucas threads bastam: cada quadro é curto e a GUI só mostra 40 por segundo
+    const int numThreads = juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 2);
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        pool.push_back(std::make_unique<PoolThread>(*this, i));
+        pool.back()->startThread(juce::Thread::Priority::low);
+    }
+
+    startTimerHz(frameRateHz);
+}
+
+AnalysisService::~AnalysisService()
+{
+    stopTimer();
+
+    // Todas as análises e editores já devem ter saído
+    jassert(workers.empty() && listeners.isEmpty());
+    pool.clear();
+}
+
+const AnalysisService::FftPlan& AnalysisService::getPlan(int order)
+{
+    jassert(juce::isPositiveAndBelow(order, (int) plans.size()));
+
+    const juce::ScopedLock lock(planLock);
+    auto& plan = plans[(size_t) order];
+
+    if (plan == nullptr)
+        plan = std::make_unique<FftPlan>(order);
+
+    return *plan;
+}
+
+void AnalysisService::addWorker(SpectrumAnalysisWorker* worker)
+{
+    const juce::ScopedLock lock(workerLock);
+    workers.push_back(worker);
+}
+
+void AnalysisService::removeWorker(SpectrumAnalysisWorker* worker)
+{
+    {
+        const juce::ScopedLock lock(workerLock);
+        workers.erase(std::remove(workers.begin(), workers.end(), worker), workers.end());
+    }
+
+    // Fora da lista, nenhuma thread consegue pegá-la de novo; só falta
+    // esperar a que já estiver com ela. Um sinal antigo só repete o teste
+    while (worker->isBusy())
+        releaseEvent.wait(-1);
+}
+
+// Depois de release() a análise pode ser destruída: daqui em diante só o
+// serviço é usado
+void AnalysisService::workerReleased(SpectrumAnalysisWorker* worker) noexcept
+{
+    worker->release();
+    releaseEvent.signal();
+}
+
+void AnalysisService::notifyWorkPending() noexcept
+{
+    // Em rodízio; uma thread ocupada pega o trabalho assim que terminar,
+    // porque o aviso fica guardado até o próximo wait
+    const size_t index = nextNotified.fetch_add(1, std::memory_order_relaxed) % pool.size();
+    pool[index]->notify();
+}
+
+// Escolhe em rodízio a próxima análise com trabalho pendente e livre
+SpectrumAnalysisWorker* AnalysisService::claimNextWorker()
+{
+    const juce::ScopedLock lock(workerLock);
+    const size_t numWorkers = workers.size();
+
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        const size_t index = (nextWorker + i) % numWorkers;
+        auto* worker = workers[index];
+
+        if (worker->hasPendingWork() && worker->tryClaim())
+        {
+            nextWorker = index + 1;
+            return worker;
+        }
+    }
+
+    return nullptr;
+}
+
+void AnalysisService::addListener(Listener* listener)
+{
+    listeners.addIfNotAlreadyThere(listener);
+}
+
+void AnalysisService::removeListener(Listener* listener)
+{
+    listeners.removeFirstMatchingValue(listener);
+}
+
+void AnalysisService::timerCallback()
+{
+    // Cópia: um editor pode fechar durante o aviso
+    const auto current = listeners;
+
+    for (auto* listener : current)
+        if (listeners.contains(listener))
+            listener->analysisFrameTick();
+}
@@ -0,0 +1,102 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class SpectrumAnalysisWorker;
+
+//==============================================================================
+/** Serviço de análise compartilhado por todas as instâncias do plugin no
+    processo (obtido com juce::SharedResourcePointer).
+
+    - Um pequeno grupo de threads atende as análises de todos os editores:
+      cada thread pega a próxima análise com amostras pendentes, processa
+      tudo o que houver na fila dela e passa para a seguinte. Sem trabalho,
+      as threads dormem até uma análise avisar que tem um quadro pendente.
+    - Planos de FFT e tabelas de janela são criados uma vez por tamanho e
+      compartilhados por todas as análises.
+    - Um único timer na thread de mensagens avisa os editores registrados,
+      que só pedem análise e redesenho enquanto estão visíveis.
+*/
+class AnalysisService : private juce::Timer
+{
+public:
+    static constexpr int frameRateHz = 40;
+
+    // FFT e janela de Hann de um tamanho; imutáveis depois de criados
+    struct FftPlan
+    {
+        explicit FftPlan(int order);
+
+        juce::dsp::FFT fft;
+        std::vector<float> window;
+        int size;
+    };
+
+    // Recebe o aviso de cada quadro na thread de mensagens
+    struct Listener
+    {
+        virtual ~Listener() = default;
+        virtual void analysisFrameTick() = 0;
+    };
+
+    AnalysisService();
+    ~AnalysisService() override;
+
+    // Pode ser chamado de qualquer thread; o plano vive enquanto o serviço existir
+    const FftPlan& getPlan(int order);
+
+    // Análises atendidas pelas threads do serviço. removeWorker espera a
+    // análise terminar se alguma thread estiver com ela
+    void addWorker(SpectrumAnalysisWorker* worker);
+    void removeWorker(SpectrumAnalysisWorker* worker);
+
+    // Qualquer thread, inclusive a de áudio: acorda uma thread do grupo
+    void notifyWorkPending() noexcept;
+
+    // Apenas na thread de mensagens
+    void addListener(Listener* listener);
+    void removeListener(Listener* listener);
+
+private:
+    class PoolThread;
+
+    void timerCallback() override;
+    SpectrumAnalysisWorker* claimNextWorker();
+    void workerReleased(SpectrumAnalysisWorker* worker) noexcept;
+
+    juce::CriticalSection planLock;
+    std::array<std::unique_ptr<FftPlan>, 16> plans; // índice = ordem da FFT
+
+    juce::CriticalSection workerLock;
+    std::vector<SpectrumAnalysisWorker*> workers;
+    size_t nextWorker = 0;
+
+    juce::WaitableEvent releaseEvent; // sinalizado a cada análise liberada
+
+    std::vector<std::unique_ptr<PoolThread>> pool; // fixo depois do construtor
+    std::atomic<size_t> nextNotified { 0 };
+    juce::Array<Listener*> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisService)
+};
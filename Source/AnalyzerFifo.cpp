@@ -0,0 +1,102 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "AnalyzerFifo.h"
+
+AnalyzerFifo::AnalyzerFifo(int capacity)
+    : fifo(capacity),
+      rings(NUM_ANALYZER_TAPS, std::vector<float>(static_cast<size_t>(capacity), 0.0f))
+{
+}
+
+int AnalyzerFifo::push(const float* const* taps, int numSamples) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    for (int tap = 0; tap < NUM_ANALYZER_TAPS; ++tap)
+    {
+        auto* ring = rings[(size_t) tap].data();
+
+        if (size1 > 0)
+            std::memcpy(ring + start1, taps[tap], static_cast<size_t>(size1) * sizeof(float));
+
+        if (size2 > 0)
+            std::memcpy(ring + start2, taps[tap] + size1, static_cast<size_t>(size2) * sizeof(float));
+    }
+
+    fifo.finishedWrite(size1 + size2);
+
+    if (! consumerNotified.load(std::memory_order_relaxed)
+        && fifo.getNumReady() >= samplesRequested.load(std::memory_order_relaxed)
+        && ! consumerNotified.exchange(true))
+        notifyConsumer();
+
+    return size1 + size2;
+}
+
+int AnalyzerFifo::pop(float* const* dest, int numSamples) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numSamples, start1, size1, start2, size2);
+
+    for (int tap = 0; tap < NUM_ANALYZER_TAPS; ++tap)
+    {
+        const auto* ring = rings[(size_t) tap].data();
+
+        if (size1 > 0)
+            std::memcpy(dest[tap], ring + start1, static_cast<size_t>(size1) * sizeof(float));
+
+        if (size2 > 0)
+            std::memcpy(dest[tap] + size1, ring + start2, static_cast<size_t>(size2) * sizeof(float));
+    }
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+void AnalyzerFifo::discardAll() noexcept
+{
+    fifo.finishedRead(fifo.getNumReady());
+}
+
+void AnalyzerFifo::notifyConsumer() noexcept
+{
+    // O contador impede que setConsumer(nullptr) volte enquanto o aviso
+    // ainda usa o consumidor anterior
+    ++activeNotifications;
+
+    if (auto* current = consumer.load())
+        current->samplesReady();
+
+    --activeNotifications;
+}
+
+void AnalyzerFifo::setConsumer(Consumer* newConsumer) noexcept
+{
+    consumer.store(newConsumer);
+
+    // Espera no máximo um aviso, que só acorda uma thread
+    while (activeNotifications.load() != 0)
+        juce::Thread::yield();
+}
+
+void AnalyzerFifo::requestSamples(int numSamples) noexcept
+{
+    // A AbstractFifo guarda no máximo capacity - 1 amostras
+    samplesRequested.store(juce::jlimit(1, fifo.getTotalSize() - 1, numSamples), std::memory_order_relaxed);
+    consumerNotified.store(false);
+}
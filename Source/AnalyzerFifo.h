@@ -0,0 +1,81 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+
+// Pontos de captura do analisador; todos passam pela mesma fila
+enum AnalyzerTap {
+    INPUT_TAP,  // antes do equalizador
+    OUTPUT_TAP, // depois do equalizador
+    NUM_ANALYZER_TAPS
+};
+
+//==============================================================================
+/** Fila circular sem locks entre a thread de áudio (única produtora) e a
+    thread de análise (única consumidora).
+
+    Guarda NUM_ANALYZER_TAPS sinais mono lado a lado com um único índice de
+    leitura e escrita, então as amostras de todas as capturas entram e saem
+    sempre juntas e alinhadas.
+
+    O produtor apenas copia amostras para o anel; quando a fila está cheia,
+    as amostras excedentes são descartadas em vez de esperar o consumidor.
+    Quando a fila acumula as amostras que o consumidor pediu, o produtor o
+    avisa uma única vez até o próximo pedido.
+*/
+class AnalyzerFifo
+{
+public:
+    // Recebe o aviso na thread de áudio; deve apenas acordar quem consome
+    struct Consumer
+    {
+        virtual ~Consumer() = default;
+        virtual void samplesReady() noexcept = 0;
+    };
+
+    explicit AnalyzerFifo(int capacity);
+
+    // Produtor: taps[t] aponta para numSamples amostras da captura t;
+    // retorna quantas amostras couberam na fila
+    int push(const float* const* taps, int numSamples) noexcept;
+
+    // Consumidor: copia as mesmas posições de todas as capturas para dest[t];
+    // retorna quantas amostras foram copiadas
+    int pop(float* const* dest, int numSamples) noexcept;
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+    void discardAll() noexcept;
+
+    // Consumidor: nullptr desliga o aviso e espera um aviso em andamento
+    // terminar, então o consumidor anterior pode ser destruído em seguida
+    void setConsumer(Consumer* newConsumer) noexcept;
+
+    // Consumidor: pede um aviso quando houver numSamples amostras prontas
+    void requestSamples(int numSamples) noexcept;
+
+private:
+    void notifyConsumer() noexcept;
+
+    juce::AbstractFifo fifo;
+    std::vector<std::vector<float>> rings; // um anel por captura
+
+    std::atomic<Consumer*> consumer { nullptr };
+    std::atomic<int> activeNotifications { 0 };
+    std::atomic<int> samplesRequested { 1 };
+    std::atomic<bool> consumerNotified { false };
+};
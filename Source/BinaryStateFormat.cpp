@@ -0,0 +1,176 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "BinaryStateFormat.h"
+#include <cmath>
+#include <cstring>
+
+juce::uint32 BinaryStateFormat::fnv1a(const void* data, size_t numBytes, juce::uint32 hash) noexcept
+{
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+
+    for (size_t i = 0; i < numBytes; ++i)
+        hash = (hash ^ bytes[i]) * 16777619u;
+
+    return hash;
+}
+
+juce::uint32 BinaryStateFormat::computeLayoutHash(const juce::StringArray& parameterIDs) noexcept
+{
+    juce::uint32 hash = 2166136261u;
+
+    for (const auto& id : parameterIDs)
+    {
+        const auto utf8 = id.toRawUTF8();
+        hash = fnv1a(utf8, std::strlen(utf8) + 1, hash); // inclui o terminador como separador
+    }
+
+    return hash;
+}
+
+const juce::StringArray* BinaryStateFormat::findLayout(const std::vector<juce::StringArray>& knownLayouts, juce::uint32 layoutHash) noexcept
+{
+    for (const auto& layout : knownLayouts)
+        if (computeLayoutHash(layout) == layoutHash)
+            return &layout;
+
+    return nullptr;
+}
+
+void BinaryStateFormat::writeParameterIDs(juce::OutputStream& out, const juce::StringArray& parameterIDs)
+{
+    for (const auto& id : parameterIDs)
+    {
+        const auto utf8 = id.toRawUTF8();
+        const auto length = std::strlen(utf8);
+        jassert(length > 0 && length <= 255);
+
+        out.writeByte(static_cast<char>(length));
+        out.write(utf8, length);
+    }
+}
+
+bool BinaryStateFormat::readParameterIDs(const char* data, size_t availableBytes, int numIDs, juce::StringArray& parameterIDs, size_t& bytesRead)
+{
+    parameterIDs.clearQuick();
+    parameterIDs.ensureStorageAllocated(numIDs);
+    bytesRead = 0;
+
+    for (int i = 0; i < numIDs; ++i)
+    {
+        if (bytesRead >= availableBytes)
+            return false;
+
+        const auto length = static_cast<size_t>(static_cast<juce::uint8>(data[bytesRead]));
+        if (length == 0 || bytesRead + 1 + length > availableBytes)
+            return false;
+
+        parameterIDs.add(juce::String::fromUTF8(data + bytesRead + 1, static_cast<int>(length)));
+        bytesRead += 1 + length;
+    }
+
+    return true;
+}
+
+bool BinaryStateFormat::isBinaryState(const void* data, int sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= headerSize
+        && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+void BinaryStateFormat::write(juce::MemoryBlock& destData, const juce::StringArray& parameterIDs, const float* values)
+{
+    const int numValues = parameterIDs.size();
+
+    destData.reset();
+    juce::MemoryOutputStream out(destData, false);
+    out.preallocate(static_cast<size_t>(headerSize + numValues * (int) (sizeof(float) + 16)));
+
+    // MemoryOutputStream escreve sempre em little-endian
+    out.writeInt(static_cast<int>(magic));
+    out.writeShort(static_cast<short>(currentVersion));
+    out.writeShort(static_cast<short>(numValues));
+    out.writeInt(static_cast<int>(computeLayoutHash(parameterIDs)));
+    out.writeInt(0); // checksum, preenchido abaixo
+
+    writeParameterIDs(out, parameterIDs);
+
+    for (int i = 0; i < numValues; ++i)
+        out.writeFloat(values[i]);
+
+    // O checksum cobre os bytes já serializados depois do cabeçalho
+    const auto* payload = static_cast<const char*>(out.getData()) + headerSize;
+    const auto checksum = fnv1a(payload, out.getDataSize() - headerSize);
+
+    out.setPosition(12);
+    out.writeInt(static_cast<int>(checksum));
+    out.flush();
+}
+
+bool BinaryStateFormat::read(const void* data, int sizeInBytes, const std::vector<juce::StringArray>& knownLayouts,
+                             juce::StringArray& parameterIDs, std::vector<float>& values)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    const auto* bytes = static_cast<const char*>(data);
+    const auto version = juce::ByteOrder::littleEndianShort(bytes + 4);
+    const int numValues = juce::ByteOrder::littleEndianShort(bytes + 6);
+    const auto layoutHash = juce::ByteOrder::littleEndianInt(bytes + 8);
+    const auto checksum = juce::ByteOrder::littleEndianInt(bytes + 12);
+
+    if (version == 0 || version > currentVersion)
+        return false;
+
+    const auto* payload = bytes + headerSize;
+    const auto payloadSize = static_cast<size_t>(sizeInBytes - headerSize);
+
+    if (fnv1a(payload, payloadSize) != checksum)
+        return false;
+
+    size_t idTableSize = 0;
+
+    if (version == 1)
+    {
+        const auto* layout = findLayout(knownLayouts, layoutHash);
+        if (layout == nullptr || layout->size() != numValues)
+            return false;
+
+        parameterIDs = *layout;
+    }
+    else if (! readParameterIDs(payload, payloadSize, numValues, parameterIDs, idTableSize)
+             || computeLayoutHash(parameterIDs) != layoutHash)
+    {
+        return false;
+    }
+
+    if (payloadSize != idTableSize + static_cast<size_t>(numValues) * sizeof(float))
+        return false;
+
+    const auto* valueBytes = payload + idTableSize;
+    values.resize(static_cast<size_t>(numValues));
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        const juce::uint32 bits = juce::ByteOrder::littleEndianInt(valueBytes + i * (int) sizeof(float));
+        std::memcpy(values.data() + i, &bits, sizeof(bits));
+
+        if (! std::isfinite(values[(size_t) i]))
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,69 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <vector>
+
+//==============================================================================
+/** Formato binário compacto do estado do plugin.
+
+    Layout (little-endian):
+        uint32  magic ("PEQS")
+        uint16  versão do formato
+        uint16  número de valores
+        uint32  hash dos IDs dos parâmetros, na ordem em que são escritos
+        uint32  checksum FNV-1a de tudo o que vem depois do cabeçalho
+        tabela de IDs (versão 2): para cada valor, uint8 com o tamanho do ID
+                e os bytes do ID em UTF-8
+        float   valor de cada parâmetro, na unidade do parâmetro
+
+    Com os IDs gravados, o estado é restaurado por ID: parâmetros novos não
+    invalidam estados antigos. A versão 1 não tinha a tabela; seus IDs são
+    encontrados pelo hash entre os layouts conhecidos.
+
+    A leitura rejeita magic, versão, tamanho, layout ou checksum inválidos,
+    além de valores não finitos; nada é aplicado se alguma verificação falhar.
+*/
+struct BinaryStateFormat
+{
+    static constexpr juce::uint32 magic = 0x53514550; // "PEQS" em little-endian
+    static constexpr juce::uint16 currentVersion = 2;
+    static constexpr int headerSize = 16;
+
+    // Hash dos IDs na ordem dada; muda se parâmetros forem adicionados,
+    // removidos ou reordenados
+    static juce::uint32 computeLayoutHash(const juce::StringArray& parameterIDs) noexcept;
+
+    // O layout com o hash dado, ou nullptr se nenhum corresponder
+    static const juce::StringArray* findLayout(const std::vector<juce::StringArray>& knownLayouts, juce::uint32 layoutHash) noexcept;
+
+    // Tabela de IDs, também usada pelo banco de presets
+    static void writeParameterIDs(juce::OutputStream& out, const juce::StringArray& parameterIDs);
+    static bool readParameterIDs(const char* data, size_t availableBytes, int numIDs, juce::StringArray& parameterIDs, size_t& bytesRead);
+
+    static bool isBinaryState(const void* data, int sizeInBytes) noexcept;
+
+    static void write(juce::MemoryBlock& destData, const juce::StringArray& parameterIDs, const float* values);
+
+    // Preenche os IDs e os valores gravados e retorna true se o bloco for
+    // válido; knownLayouts resolve os IDs de blocos da versão 1
+    static bool read(const void* data, int sizeInBytes, const std::vector<juce::StringArray>& knownLayouts,
+                     juce::StringArray& parameterIDs, std::vector<float>& values);
+
+private:
+    static juce::uint32 fnv1a(const void* data, size_t numBytes, juce::uint32 hash = 2166136261u) noexcept;
+};
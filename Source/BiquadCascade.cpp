@@ -0,0 +1,291 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "BiquadCascade.h"
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::prepare(int numChannels)
+{
+    jassert(numChannels <= maxChannels);
+    numPreparedChannels = juce::jlimit(0, maxChannels, numChannels);
+    groups.resize((size_t) ((numPreparedChannels + lanesPerGroup - 1) / lanesPerGroup));
+
+    // Seções começam como identidade, valendo para todos os canais, até
+    // receberem coeficientes
+    sectionChannels.fill(allChannels);
+    targetMask = fadingMask = runningMask = 0;
+    fades.fill({});
+
+    for (int section = 0; section < maxSections; ++section)
+        setCoefficients(section, {});
+
+    rebuildActiveSections();
+    reset();
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::reset() noexcept
+{
+    for (auto& group : groups)
+        for (auto& state : group.state)
+            state.s1 = state.s2 = Lanes::expand(SampleType(0));
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::setCoefficients(int section, const BiquadCoefficients& coeffs, int channel) noexcept
+{
+    jassert(juce::isPositiveAndBelow(section, maxSections));
+
+    static constexpr BiquadCoefficients identity;
+    constexpr int numLanes = lanesPerGroup;
+
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        // Monta os valores lane a lane: o canal alvo recebe os coeficientes,
+        // os outros canais do grupo recebem a identidade
+        alignas(sizeof(Lanes)) SampleType b0[numLanes], b1[numLanes], b2[numLanes], a1[numLanes], a2[numLanes];
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const int laneChannel = static_cast<int>(g) * numLanes + lane;
+            const auto& c = (channel == allChannels || channel == laneChannel) ? coeffs : identity;
+
+            b0[lane] = static_cast<SampleType>(c.b0);
+            b1[lane] = static_cast<SampleType>(c.b1);
+            b2[lane] = static_cast<SampleType>(c.b2);
+            a1[lane] = static_cast<SampleType>(c.a1);
+            a2[lane] = static_cast<SampleType>(c.a2);
+        }
+
+        auto& lanes = groups[g].sections[(size_t) section];
+        lanes.b0 = Lanes::fromRawArray(b0);
+        lanes.b1 = Lanes::fromRawArray(b1);
+        lanes.b2 = Lanes::fromRawArray(b2);
+        lanes.a1 = Lanes::fromRawArray(a1);
+        lanes.a2 = Lanes::fromRawArray(a2);
+    }
+
+    if (sectionChannels[(size_t) section] != channel)
+    {
+        sectionChannels[(size_t) section] = channel;
+        rebuildActiveSections();
+    }
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::setActiveSections(juce::uint32 mask, bool crossfade) noexcept
+{
+    const auto changed = mask ^ targetMask;
+    targetMask = mask;
+
+    for (int section = 0; section < maxSections; ++section)
+    {
+        const auto bit = 1u << section;
+        const bool isOn = (mask & bit) != 0;
+        auto& fade = fades[(size_t) section];
+
+        // Sem crossfade, os fades em andamento também terminam na hora
+        if (! crossfade || fadeLengthSamples <= 0)
+        {
+            if (isOn && (runningMask & bit) == 0)
+                for (auto& group : groups)
+                    group.state[(size_t) section] = {};
+
+            fade = { isOn ? 1.0 : 0.0, 0.0, 0 };
+            fadingMask &= ~bit;
+            continue;
+        }
+
+        if ((changed & bit) == 0)
+            continue;
+
+        // Uma seção parada volta do zero; se ainda estava saindo, o estado
+        // continua aquecido e o fade apenas inverte o sentido
+        if (isOn && (runningMask & bit) == 0)
+        {
+            for (auto& group : groups)
+                group.state[(size_t) section] = {};
+
+            fade.mix = 0.0;
+        }
+
+        const double target = isOn ? 1.0 : 0.0;
+        fade.samplesRemaining = juce::jmax(1, juce::roundToInt(std::abs(target - fade.mix) * fadeLengthSamples));
+        fade.increment = (target - fade.mix) / fade.samplesRemaining;
+        fadingMask |= bit;
+    }
+
+    runningMask = targetMask | fadingMask;
+    rebuildActiveSections();
+}
+
+// Avança os crossfades e retira da lista as seções que terminaram de sair
+template <typename SampleType>
+void BiquadCascade<SampleType>::advanceFades(int numSamples) noexcept
+{
+    bool anyFinished = false;
+
+    for (int section = 0; section < maxSections; ++section)
+    {
+        const auto bit = 1u << section;
+        if ((fadingMask & bit) == 0)
+            continue;
+
+        auto& fade = fades[(size_t) section];
+        fade.samplesRemaining -= numSamples;
+
+        if (fade.samplesRemaining > 0)
+        {
+            fade.mix += fade.increment * numSamples;
+            continue;
+        }
+
+        fade = { (targetMask & bit) != 0 ? 1.0 : 0.0, 0.0, 0 };
+        fadingMask &= ~bit;
+        anyFinished = true;
+    }
+
+    if (anyFinished)
+    {
+        runningMask = targetMask | fadingMask;
+        rebuildActiveSections();
+    }
+}
+
+// Distribui as seções ativas entre os grupos de canais que elas afetam
+template <typename SampleType>
+void BiquadCascade<SampleType>::rebuildActiveSections() noexcept
+{
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        auto& group = groups[g];
+        const int firstChannel = static_cast<int>(g) * lanesPerGroup;
+        group.numActiveSections = 0;
+
+        for (int section = 0; section < maxSections; ++section)
+        {
+            if ((runningMask & (1u << section)) == 0)
+                continue;
+
+            const int channel = sectionChannels[(size_t) section];
+            if (channel == allChannels || (channel >= firstChannel && channel < firstChannel + lanesPerGroup))
+                group.activeSections[(size_t) group.numActiveSections++] = section;
+        }
+    }
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::process(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept
+{
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+
+    while (runningMask != 0 && numSamples > 0)
+    {
+        // Com crossfades em andamento, o bloco é dividido onde algum termina
+        int segmentSize = numSamples;
+
+        for (int section = 0; section < maxSections; ++section)
+            if ((fadingMask & (1u << section)) != 0)
+                segmentSize = juce::jmin(segmentSize, fades[(size_t) section].samplesRemaining);
+
+        for (int firstChannel = 0, group = 0; firstChannel < numChannels; firstChannel += lanesPerGroup, ++group)
+        {
+            auto& laneGroup = groups[(size_t) group];
+            const int numLanes = juce::jmin(lanesPerGroup, numChannels - firstChannel);
+
+            if (fadingMask != 0)
+                processGroup<true>(laneGroup, channels + firstChannel, numLanes, startSample, segmentSize);
+            else
+                processGroup<false>(laneGroup, channels + firstChannel, numLanes, startSample, segmentSize);
+        }
+
+        if (fadingMask != 0)
+            advanceFades(segmentSize);
+
+        startSample += segmentSize;
+        numSamples -= segmentSize;
+    }
+}
+
+template <typename SampleType>
+template <bool isFading>
+void BiquadCascade<SampleType>::processGroup(LaneGroup& group, SampleType* const* channels, int numLanes, int startSample, int numSamples) noexcept
+{
+    // Copia coeficientes e estados das seções ativas para variáveis locais,
+    // permitindo que o compilador os mantenha em registradores durante o bloco
+    const int numSections = group.numActiveSections;
+    if (numSections == 0)
+        return;
+
+    SectionLanes c[maxSections];
+    StateLanes s[maxSections];
+    Lanes mix[maxSections], mixIncrement[maxSections];
+
+    for (int k = 0; k < numSections; ++k)
+    {
+        const auto section = (size_t) group.activeSections[(size_t) k];
+        c[k] = group.sections[section];
+        s[k] = group.state[section];
+
+        if constexpr (isFading)
+        {
+            mix[k] = Lanes::expand(static_cast<SampleType>(fades[section].mix));
+            mixIncrement[k] = Lanes::expand(static_cast<SampleType>(fades[section].increment));
+        }
+    }
+
+    // Lanes sem canal correspondente recebem sempre zero
+    alignas(sizeof(Lanes)) SampleType in[Lanes::size()] = {};
+    alignas(sizeof(Lanes)) SampleType out[Lanes::size()] = {};
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+            in[lane] = channels[lane][i];
+
+        auto x = Lanes::fromRawArray(in);
+
+        // Forma direta II transposta, seção a seção
+        for (int k = 0; k < numSections; ++k)
+        {
+            const auto y = c[k].b0 * x + s[k].s1;
+            s[k].s1 = c[k].b1 * x - c[k].a1 * y + s[k].s2;
+            s[k].s2 = c[k].b2 * x - c[k].a2 * y;
+
+            if constexpr (isFading)
+            {
+                // Seções fora do crossfade têm mistura 1 e incremento 0
+                x = x + mix[k] * (y - x);
+                mix[k] = mix[k] + mixIncrement[k];
+            }
+            else
+            {
+                x = y;
+            }
+        }
+
+        x.copyToRawArray(out);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            channels[lane][i] = out[lane];
+    }
+
+    for (int k = 0; k < numSections; ++k)
+        group.state[(size_t) group.activeSections[(size_t) k]] = s[k];
+}
+
+template class BiquadCascade<float>;
+template class BiquadCascade<double>;
@@ -0,0 +1,138 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+
+// Coeficientes de uma seção biquad, já normalizados por a0:
+// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+// Ficam sempre em double; a cascata os arredonda para o tipo de amostra
+struct BiquadCoefficients
+{
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+};
+
+//==============================================================================
+/** Cascata de até maxSections biquads processada em uma única passada.
+
+    Cada amostra atravessa todas as seções ativas antes de passar para a
+    próxima, então o buffer é lido e escrito apenas uma vez por bloco.
+    Os canais são agrupados nas lanes de um registrador SIMD (SSE/AVX em
+    x86, NEON em ARM) e o estado dos filtros fica em variáveis locais
+    durante todo o bloco. Cada seção pode valer para todos os canais ou
+    para um único canal; grupos de canais que uma seção não afeta não a
+    processam.
+
+    SampleType pode ser float ou double; com double, coeficientes e estados
+    também ficam em double.
+
+    Seções que entram ou saem da lista de ativas passam por um crossfade
+    curto (y = x + m (f(x) - x)) e continuam sendo processadas até o fim
+    dele, então ligar ou desligar uma banda não causa cliques.
+*/
+template <typename SampleType>
+class BiquadCascade
+{
+public:
+    static constexpr int maxSections = 8;
+    static constexpr int maxChannels = 16;
+    static constexpr int allChannels = -1;
+
+   #if JUCE_USE_SIMD
+    using Lanes = juce::dsp::SIMDRegister<SampleType>;
+   #else
+    // Sem SIMD disponível, cada "registrador" carrega um único canal
+    struct Lanes
+    {
+        SampleType value;
+
+        static constexpr size_t size() noexcept                   { return 1; }
+        static Lanes expand(SampleType v) noexcept                { return { v }; }
+        static Lanes fromRawArray(const SampleType* a) noexcept   { return { *a }; }
+        void copyToRawArray(SampleType* a) const noexcept         { *a = value; }
+
+        Lanes operator+ (Lanes o) const noexcept { return { value + o.value }; }
+        Lanes operator- (Lanes o) const noexcept { return { value - o.value }; }
+        Lanes operator* (Lanes o) const noexcept { return { value * o.value }; }
+
+        static Lanes max(Lanes a, Lanes b) noexcept               { return { juce::jmax(a.value, b.value) }; }
+        static Lanes min(Lanes a, Lanes b) noexcept               { return { juce::jmin(a.value, b.value) }; }
+    };
+   #endif
+
+    static constexpr int lanesPerGroup = (int) Lanes::size();
+
+    // Aloca o estado para o número de canais; deve ser chamado fora da thread de áudio
+    void prepare(int numChannels);
+    void reset() noexcept;
+
+    // Define os coeficientes de uma seção para todos os canais ou, se channel
+    // não for allChannels, apenas para aquele canal (os demais ficam neutros)
+    void setCoefficients(int section, const BiquadCoefficients& coeffs, int channel = allChannels) noexcept;
+
+    // Define quais seções participam do processamento (bit n = seção n).
+    // Com crossfade, as seções que mudaram entram ou saem gradualmente;
+    // sem ele, a troca é imediata
+    void setActiveSections(juce::uint32 mask, bool crossfade = true) noexcept;
+
+    // Duração do crossfade ao ligar ou desligar uma seção
+    void setFadeLength(int numSamples) noexcept { fadeLengthSamples = juce::jmax(0, numSamples); }
+
+    // Processa as amostras [startSample, startSample + numSamples) de cada canal
+    void process(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+
+private:
+    struct SectionLanes { Lanes b0, b1, b2, a1, a2; };
+    struct StateLanes   { Lanes s1, s2; };
+
+    // Um grupo processa Lanes::size() canais em paralelo
+    struct LaneGroup
+    {
+        std::array<SectionLanes, maxSections> sections;
+        std::array<StateLanes, maxSections> state;
+
+        // Seções ativas que afetam algum canal deste grupo
+        std::array<int, maxSections> activeSections {};
+        int numActiveSections = 0;
+    };
+
+    // Mistura entre a entrada e a saída de uma seção durante o crossfade
+    struct SectionFade
+    {
+        double mix = 0.0, increment = 0.0;
+        int samplesRemaining = 0;
+    };
+
+    void rebuildActiveSections() noexcept;
+    void advanceFades(int numSamples) noexcept;
+
+    // Dois kernels: o normal e o que aplica a mistura das seções em crossfade
+    template <bool isFading>
+    void processGroup(LaneGroup& group, SampleType* const* channels, int numLanes, int startSample, int numSamples) noexcept;
+
+    std::vector<LaneGroup> groups;
+    int numPreparedChannels = 0;
+
+    juce::uint32 targetMask = 0;  // seções pedidas em setActiveSections
+    juce::uint32 fadingMask = 0;  // seções em crossfade
+    juce::uint32 runningMask = 0; // seções processadas: pedidas ou ainda saindo
+    std::array<SectionFade, maxSections> fades;
+    int fadeLengthSamples = 0;
+
+    std::array<int, maxSections> sectionChannels {}; // canal de cada seção ou allChannels
+};
@@ -0,0 +1,356 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "CoefficientDesigner.h"
+#include <cmath>
+
+namespace
+{
+    // Normaliza por a0 e converte para a estrutura usada pela cascata
+    BiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1, double a2) noexcept
+    {
+        const double inv = 1.0 / a0;
+        return { b0 * inv, b1 * inv, b2 * inv, a1 * inv, a2 * inv };
+    }
+}
+
+BiquadCoefficients CoefficientDesigner::design(FilterType type, double sampleRate, float freq, float q, float gainDb,
+                                               DesignMethod method) noexcept
+{
+    const double gainFactor = std::pow(10.0, gainDb * 0.05);
+
+    if (method == MATCHED)
+        return makeMatched(type, sampleRate, freq, q, gainFactor);
+
+    switch (type)
+    {
+        case PEAK:       return makePeakFilter(sampleRate, freq, q, gainFactor);
+        case LOW_SHELF:  return makeLowShelf(sampleRate, freq, q, gainFactor);
+        case HIGH_SHELF: return makeHighShelf(sampleRate, freq, q, gainFactor);
+        case LOW_PASS:   return makeLowPass(sampleRate, freq, q);
+        case HIGH_PASS:  return makeHighPass(sampleRate, freq, q);
+        default:         return {};
+    }
+}
+
+BiquadCoefficients CoefficientDesigner::makePeakFilter(double sampleRate, double freq, double q, double gainFactor) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0 && freq <= sampleRate * 0.5 && q > 0.0);
+
+    const double A = std::sqrt(juce::jmax(0.0, gainFactor));
+    const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+    const double alpha = std::sin(omega) / (q * 2.0);
+    const double c2 = -2.0 * std::cos(omega);
+    const double alphaTimesA = alpha * A;
+    const double alphaOverA = alpha / A;
+
+    return normalise(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA,
+                     1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+}
+
+BiquadCoefficients CoefficientDesigner::makeLowShelf(double sampleRate, double freq, double q, double gainFactor) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0 && freq <= sampleRate * 0.5 && q > 0.0);
+
+    const double A = std::sqrt(juce::jmax(0.0, gainFactor));
+    const double aminus1 = A - 1.0;
+    const double aplus1 = A + 1.0;
+    const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+    const double coso = std::cos(omega);
+    const double beta = std::sin(omega) * std::sqrt(A) / q;
+    const double aminus1TimesCoso = aminus1 * coso;
+
+    return normalise(A * (aplus1 - aminus1TimesCoso + beta),
+                     A * 2.0 * (aminus1 - aplus1 * coso),
+                     A * (aplus1 - aminus1TimesCoso - beta),
+                     aplus1 + aminus1TimesCoso + beta,
+                     -2.0 * (aminus1 + aplus1 * coso),
+                     aplus1 + aminus1TimesCoso - beta);
+}
+
+BiquadCoefficients CoefficientDesigner::makeHighShelf(double sampleRate, double freq, double q, double gainFactor) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0 && freq <= sampleRate * 0.5 && q > 0.0);
+
+    const double A = std::sqrt(juce::jmax(0.0, gainFactor));
+    const double aminus1 = A - 1.0;
+    const double aplus1 = A + 1.0;
+    const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+    const double coso = std::cos(omega);
+    const double beta = std::sin(omega) * std::sqrt(A) / q;
+    const double aminus1TimesCoso = aminus1 * coso;
+
+    return normalise(A * (aplus1 + aminus1TimesCoso + beta),
+                     A * -2.0 * (aminus1 + aplus1 * coso),
+                     A * (aplus1 + aminus1TimesCoso - beta),
+                     aplus1 - aminus1TimesCoso + beta,
+                     2.0 * (aminus1 - aplus1 * coso),
+                     aplus1 - aminus1TimesCoso - beta);
+}
+
+BiquadCoefficients CoefficientDesigner::makeLowPass(double sampleRate, double freq, double q) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0 && freq <= sampleRate * 0.5 && q > 0.0);
+
+    const double n = 1.0 / std::tan(juce::MathConstants<double>::pi * freq / sampleRate);
+    const double nSquared = n * n;
+    const double invQ = 1.0 / q;
+    const double c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return normalise(c1, c1 * 2.0, c1,
+                     1.0, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared));
+}
+
+BiquadCoefficients CoefficientDesigner::makeHighPass(double sampleRate, double freq, double q) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0 && freq <= sampleRate * 0.5 && q > 0.0);
+
+    const double n = std::tan(juce::MathConstants<double>::pi * freq / sampleRate);
+    const double nSquared = n * n;
+    const double invQ = 1.0 / q;
+    const double c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return normalise(c1, c1 * -2.0, c1,
+                     1.0, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared));
+}
+
+BiquadCoefficients CoefficientDesigner::makeBandPass(double sampleRate, double freq, double q) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0 && freq <= sampleRate * 0.5 && q > 0.0);
+
+    const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+    const double alpha = std::sin(omega) / (q * 2.0);
+
+    return normalise(alpha, 0.0, -alpha,
+                     1.0 + alpha, -2.0 * std::cos(omega), 1.0 - alpha);
+}
+
+BiquadCoefficients CoefficientDesigner::makeMatched(FilterType type, double sampleRate, double freq, double q, double gainFactor) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0 && freq <= sampleRate * 0.5 && q > 0.0);
+
+    const double A = std::sqrt(juce::jmax(1.0e-6, gainFactor));
+    const double w0 = juce::MathConstants<double>::twoPi * freq / sampleRate;
+
+    // Frequência e Q dos polos analógicos de cada protótipo
+    double poleFreq = w0, poleQ = q;
+
+    switch (type)
+    {
+        case PEAK:       poleQ = q * A; break;
+        case LOW_SHELF:  poleFreq = w0 / std::sqrt(A); break;
+        case HIGH_SHELF: poleFreq = w0 * std::sqrt(A); break;
+        case LOW_PASS:
+        case HIGH_PASS:
+        default:         break;
+    }
+
+    // Polos por invariância ao impulso; a frequência amortecida é limitada a
+    // Nyquist para que polos acima dele não se dobrem para baixo
+    const double zeta = 0.5 / poleQ;
+    const double decay = std::exp(-zeta * poleFreq);
+    const double a1 = zeta <= 1.0
+                        ? -2.0 * decay * std::cos(juce::jmin(juce::MathConstants<double>::pi, std::sqrt(1.0 - zeta * zeta) * poleFreq))
+                        : -2.0 * decay * std::cosh(std::sqrt(zeta * zeta - 1.0) * poleFreq);
+    const double a2 = std::exp(-2.0 * zeta * poleFreq);
+
+    // |H|^2 = (B0 phi0 + B1 phi1 + B2 phi2) / (A0 phi0 + A1 phi1 + A2 phi2)
+    const double A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+    const double A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+    const double A2 = -4.0 * a2;
+
+    const double sinHalf = std::sin(0.5 * w0);
+    const double phi1 = sinHalf * sinHalf;
+    const double phi0 = 1.0 - phi1;
+    const double phi2 = 4.0 * phi0 * phi1;
+
+    const auto analogSquared = [&](double f)
+    {
+        const double m = getAnalogMagnitude(type, f, freq, q, gainFactor);
+        return m * m;
+    };
+
+    const double B0 = A0 * analogSquared(0.0);
+    const double B1 = A1 * analogSquared(sampleRate * 0.5);
+    const double B2 = phi2 > 1.0e-12
+                        ? (analogSquared(freq) * (A0 * phi0 + A1 * phi1 + A2 * phi2) - B0 * phi0 - B1 * phi1) / phi2
+                        : 0.0;
+
+    const double sqrtB0 = std::sqrt(juce::jmax(0.0, B0));
+    const double sqrtB1 = std::sqrt(juce::jmax(0.0, B1));
+    const double W = 0.5 * (sqrtB0 + sqrtB1);
+    const double b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+    const double b1 = 0.5 * (sqrtB0 - sqrtB1);
+    const double b2 = b0 > 0.0 ? -B2 / (4.0 * b0) : 0.0;
+
+    return { b0, b1, b2, a1, a2 };
+}
+
+double CoefficientDesigner::getAnalogMagnitude(FilterType type, double freq, double centreFreq, double q, double gainFactor) noexcept
+{
+    // Protótipos em s = jx, com x = freq / centreFreq, equivalentes às
+    // fórmulas bilineares acima antes da transformação
+    const double A = std::sqrt(juce::jmax(1.0e-6, gainFactor));
+    const double x = freq / centreFreq;
+    const double x2 = x * x;
+
+    const auto magnitude = [](double numRe, double numIm, double denRe, double denIm)
+    {
+        return std::sqrt((numRe * numRe + numIm * numIm) / juce::jmax(denRe * denRe + denIm * denIm, 1.0e-30));
+    };
+
+    switch (type)
+    {
+        case PEAK:       return magnitude(1.0 - x2, x * A / q, 1.0 - x2, x / (A * q));
+        case LOW_SHELF:  return A * magnitude(A - x2, std::sqrt(A) * x / q, 1.0 - A * x2, std::sqrt(A) * x / q);
+        case HIGH_SHELF: return A * magnitude(1.0 - A * x2, std::sqrt(A) * x / q, A - x2, std::sqrt(A) * x / q);
+        case LOW_PASS:   return magnitude(1.0, 0.0, 1.0 - x2, x / q);
+        case HIGH_PASS:  return magnitude(-x2, 0.0, 1.0 - x2, x / q);
+        default:         return 1.0;
+    }
+}
+
+double CoefficientDesigner::getMagnitudeForFrequency(const BiquadCoefficients& c, double freq, double sampleRate) noexcept
+{
+    // |H(e^jw)|^2 expandido em cos(w) e cos(2w), sem aritmética complexa
+    const double w = juce::MathConstants<double>::twoPi * freq / sampleRate;
+    const double cosw = std::cos(w);
+    const double cos2w = std::cos(2.0 * w);
+
+    const double b0 = c.b0, b1 = c.b1, b2 = c.b2, a1 = c.a1, a2 = c.a2;
+    const double num = b0 * b0 + b1 * b1 + b2 * b2 + 2.0 * (b0 * b1 + b1 * b2) * cosw + 2.0 * b0 * b2 * cos2w;
+    const double den = 1.0 + a1 * a1 + a2 * a2 + 2.0 * (a1 + a1 * a2) * cosw + 2.0 * a2 * cos2w;
+
+    return std::sqrt(juce::jmax(0.0, num) / juce::jmax(den, 1.0e-30));
+}
+
+//==============================================================================
+void GainOnlyDesigner::prepare(FilterType type, double sampleRate, float freq, float q) noexcept
+{
+    jassert(sampleRate > 0.0 && freq > 0.0f && freq <= sampleRate * 0.5 && q > 0.0f);
+
+    preparedType = type;
+    preparedRate = sampleRate;
+    preparedFreq = freq;
+    preparedQ = q;
+
+    const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+    cosOmega = std::cos(omega);
+    sinOmegaOverQ = std::sin(omega) / q;
+}
+
+// Mesmas fórmulas de makePeakFilter, makeLowShelf e makeHighShelf, com
+// A = sqrt(10^(gainDb / 20)) = 10^(gainDb / 40)
+BiquadCoefficients GainOnlyDesigner::design(float gainDb) const noexcept
+{
+    constexpr double ln10Over40 = 2.302585092994046 / 40.0;
+    const double A = std::exp(gainDb * ln10Over40);
+
+    if (preparedType == PEAK)
+    {
+        const double alpha = sinOmegaOverQ * 0.5;
+        const double c2 = -2.0 * cosOmega;
+
+        return normalise(1.0 + alpha * A, c2, 1.0 - alpha * A,
+                         1.0 + alpha / A, c2, 1.0 - alpha / A);
+    }
+
+    const double aminus1 = A - 1.0;
+    const double aplus1 = A + 1.0;
+    const double beta = sinOmegaOverQ * std::sqrt(A);
+    const double aminus1TimesCoso = aminus1 * cosOmega;
+
+    if (preparedType == LOW_SHELF)
+        return normalise(A * (aplus1 - aminus1TimesCoso + beta),
+                         A * 2.0 * (aminus1 - aplus1 * cosOmega),
+                         A * (aplus1 - aminus1TimesCoso - beta),
+                         aplus1 + aminus1TimesCoso + beta,
+                         -2.0 * (aminus1 + aplus1 * cosOmega),
+                         aplus1 + aminus1TimesCoso - beta);
+
+    jassert(preparedType == HIGH_SHELF);
+    return normalise(A * (aplus1 + aminus1TimesCoso + beta),
+                     A * -2.0 * (aminus1 + aplus1 * cosOmega),
+                     A * (aplus1 + aminus1TimesCoso - beta),
+                     aplus1 - aminus1TimesCoso + beta,
+                     2.0 * (aminus1 - aplus1 * cosOmega),
+                     aplus1 - aminus1TimesCoso - beta);
+}
+
+//==============================================================================
+CoefficientSlots::CoefficientSlots() noexcept
+{
+    for (int band = 0; band < numSlots; ++band)
+    {
+        for (auto& buffer : slots[(size_t) band].buffers)
+        {
+            // Identidade: b0 = 1, demais coeficientes zerados
+            buffer[0].store(1.0, std::memory_order_relaxed);
+            for (size_t i = 1; i < buffer.size(); ++i)
+                buffer[i].store(0.0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void CoefficientSlots::publish(int band, const BiquadCoefficients& coeffs) noexcept
+{
+    jassert(juce::isPositiveAndBelow(band, numSlots));
+    auto& slot = slots[(size_t) band];
+
+    // Marca a escrita (ímpar) antes de tocar no buffer inativo
+    const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& buffer = slot.buffers[((sequence >> 1) + 1) & 1];
+    buffer[0].store(coeffs.b0, std::memory_order_relaxed);
+    buffer[1].store(coeffs.b1, std::memory_order_relaxed);
+    buffer[2].store(coeffs.b2, std::memory_order_relaxed);
+    buffer[3].store(coeffs.a1, std::memory_order_relaxed);
+    buffer[4].store(coeffs.a2, std::memory_order_relaxed);
+
+    // Troca o buffer publicado
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+BiquadCoefficients CoefficientSlots::read(int band) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(band, numSlots));
+    const auto& slot = slots[(size_t) band];
+
+    for (;;)
+    {
+        // Com a sequência ímpar o escritor está no outro buffer, então o
+        // publicado continua sendo o da última sequência par
+        const auto before = slot.sequence.load(std::memory_order_acquire) & ~1u;
+        const auto& buffer = slot.buffers[(before >> 1) & 1];
+
+        BiquadCoefficients coeffs;
+        coeffs.b0 = buffer[0].load(std::memory_order_relaxed);
+        coeffs.b1 = buffer[1].load(std::memory_order_relaxed);
+        coeffs.b2 = buffer[2].load(std::memory_order_relaxed);
+        coeffs.a1 = buffer[3].load(std::memory_order_relaxed);
+        coeffs.a2 = buffer[4].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto after = slot.sequence.load(std::memory_order_relaxed);
+
+        // O buffer lido só volta a ser escrito a partir da sequência
+        // before + 3; se isso aconteceu durante a leitura, tenta novamente
+        if (after - before <= 2)
+            return coeffs;
+    }
+}
@@ -0,0 +1,137 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include "BiquadCascade.h"
+
+// Enumeração para os tipos de filtro
+enum FilterType {
+    PEAK,
+    LOW_SHELF,
+    HIGH_SHELF,
+    LOW_PASS,
+    HIGH_PASS
+};
+
+// Método de projeto dos coeficientes
+enum DesignMethod {
+    BILINEAR, // transformada bilinear (fórmulas da JUCE/RBJ)
+    MATCHED   // magnitude casada com o protótipo analógico até Nyquist
+};
+
+//==============================================================================
+/** Projeto de coeficientes biquad sem alocação nem locks.
+
+    Usa as mesmas fórmulas de juce::dsp::IIR::Coefficients (makePeakFilter,
+    makeLowShelf, etc.), mas calcula em double e devolve uma estrutura POD,
+    então pode ser chamado da thread de áudio e da GUI ao mesmo tempo.
+*/
+struct CoefficientDesigner
+{
+    static BiquadCoefficients design(FilterType type, double sampleRate, float freq, float q, float gainDb,
+                                     DesignMethod method = BILINEAR) noexcept;
+
+    static BiquadCoefficients makePeakFilter(double sampleRate, double freq, double q, double gainFactor) noexcept;
+    static BiquadCoefficients makeLowShelf(double sampleRate, double freq, double q, double gainFactor) noexcept;
+    static BiquadCoefficients makeHighShelf(double sampleRate, double freq, double q, double gainFactor) noexcept;
+    static BiquadCoefficients makeLowPass(double sampleRate, double freq, double q) noexcept;
+    static BiquadCoefficients makeHighPass(double sampleRate, double freq, double q) noexcept;
+
+    // Passa-banda com ganho unitário no centro; usado nos detectores das
+    // bandas dinâmicas
+    static BiquadCoefficients makeBandPass(double sampleRate, double freq, double q) noexcept;
+
+    // Projeto casado (Vicanek, "Matched Second Order Digital Filters"): polos
+    // por invariância ao impulso e zeros escolhidos para que a magnitude seja
+    // igual à do protótipo analógico em DC, em Nyquist e em freq
+    static BiquadCoefficients makeMatched(FilterType type, double sampleRate, double freq, double q, double gainFactor) noexcept;
+
+    // Magnitude linear da seção na frequência dada
+    static double getMagnitudeForFrequency(const BiquadCoefficients& coeffs, double freq, double sampleRate) noexcept;
+
+    // Magnitude linear do protótipo analógico que os dois métodos aproximam
+    static double getAnalogMagnitude(FilterType type, double freq, double centreFreq, double q, double gainFactor) noexcept;
+};
+
+//==============================================================================
+/** Reprojeto de bandas peak e shelf quando só o ganho muda.
+
+    prepare() guarda os termos que dependem da frequência e do Q (cos w0 e
+    sin w0); design() refaz as fórmulas bilineares de CoefficientDesigner
+    com uma exponencial e uma raiz, sem funções trigonométricas. As bandas
+    dinâmicas mudam o ganho na taxa de controle e usam este caminho. No
+    projeto casado todos os termos dependem do ganho, então não há atalho.
+*/
+class GainOnlyDesigner
+{
+public:
+    static bool supports(FilterType type, DesignMethod method) noexcept
+    {
+        return method == BILINEAR && (type == PEAK || type == LOW_SHELF || type == HIGH_SHELF);
+    }
+
+    void prepare(FilterType type, double sampleRate, float freq, float q) noexcept;
+
+    bool isPreparedFor(FilterType type, double sampleRate, float freq, float q) const noexcept
+    {
+        return type == preparedType && sampleRate == preparedRate && freq == preparedFreq && q == preparedQ;
+    }
+
+    BiquadCoefficients design(float gainDb) const noexcept;
+
+private:
+    FilterType preparedType = PEAK;
+    double preparedRate = 0.0;
+    float preparedFreq = 0.0f, preparedQ = 0.0f;
+
+    double cosOmega = 1.0;
+    double sinOmegaOverQ = 0.0;
+};
+
+//==============================================================================
+/** Coeficientes de cada banda publicados por uma única thread escritora
+    (a thread de áudio) e lidos por qualquer outra thread.
+
+    Cada banda tem dois buffers: o escritor preenche o buffer inativo e então
+    avança o contador de sequência, que indica qual buffer está publicado.
+    Leitores nunca bloqueiam o escritor; se o buffer lido for reutilizado
+    durante a leitura, a leitura é simplesmente repetida.
+*/
+class CoefficientSlots
+{
+public:
+    static constexpr int numSlots = BiquadCascade<float>::maxSections;
+
+    CoefficientSlots() noexcept;
+
+    // Apenas a thread escritora pode chamar
+    void publish(int band, const BiquadCoefficients& coeffs) noexcept;
+
+    // Pode ser chamado de qualquer thread
+    BiquadCoefficients read(int band) const noexcept;
+
+private:
+    struct Slot
+    {
+        std::array<std::array<std::atomic<double>, 5>, 2> buffers;
+        std::atomic<juce::uint32> sequence { 0 }; // par = publicado, ímpar = escrevendo
+    };
+
+    std::array<Slot, numSlots> slots;
+};
@@ -0,0 +1,139 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "DynamicsDetector.h"
+#include "CoefficientDesigner.h"
+
+void DynamicsDetector::prepare(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+    activeGroups = 0;
+
+    // Bandas começam com passa-banda neutro (identidade) e tempos instantâneos
+    for (auto& group : groups)
+    {
+        group.b0 = Lanes::expand(1.0f);
+        group.b1 = group.b2 = group.a1 = group.a2 = Lanes::expand(0.0f);
+        group.attack = group.release = Lanes::expand(1.0f);
+    }
+
+    reset();
+}
+
+void DynamicsDetector::reset() noexcept
+{
+    for (auto& group : groups)
+        group.s1 = group.s2 = group.envelope = Lanes::expand(0.0f);
+}
+
+void DynamicsDetector::setLane(Lanes& lanes, int lane, float value) noexcept
+{
+    alignas(sizeof(Lanes)) float raw[lanesPerGroup];
+    lanes.copyToRawArray(raw);
+    raw[lane] = value;
+    lanes = Lanes::fromRawArray(raw);
+}
+
+float DynamicsDetector::getLane(const Lanes& lanes, int lane) noexcept
+{
+    alignas(sizeof(Lanes)) float raw[lanesPerGroup];
+    lanes.copyToRawArray(raw);
+    return raw[lane];
+}
+
+// Coeficiente do seguidor de um polo para a constante de tempo dada
+float DynamicsDetector::timeToCoefficient(float milliseconds) const noexcept
+{
+    const double samples = juce::jmax(1.0, milliseconds * 0.001 * sampleRate);
+    return static_cast<float>(1.0 - std::exp(-1.0 / samples));
+}
+
+void DynamicsDetector::setBand(int band, float freq, float q, float attackMs, float releaseMs) noexcept
+{
+    jassert(juce::isPositiveAndBelow(band, maxBands));
+
+    auto& group = groups[(size_t) (band / lanesPerGroup)];
+    const int lane = band % lanesPerGroup;
+
+    const auto coeffs = CoefficientDesigner::makeBandPass(sampleRate, juce::jmin(static_cast<double>(freq), sampleRate * 0.49), q);
+    setLane(group.b0, lane, static_cast<float>(coeffs.b0));
+    setLane(group.b1, lane, static_cast<float>(coeffs.b1));
+    setLane(group.b2, lane, static_cast<float>(coeffs.b2));
+    setLane(group.a1, lane, static_cast<float>(coeffs.a1));
+    setLane(group.a2, lane, static_cast<float>(coeffs.a2));
+
+    setLane(group.attack, lane, timeToCoefficient(attackMs));
+    setLane(group.release, lane, timeToCoefficient(releaseMs));
+}
+
+void DynamicsDetector::setActiveBands(juce::uint32 mask) noexcept
+{
+    const auto laneMask = (1u << lanesPerGroup) - 1u;
+    juce::uint32 newActiveGroups = 0;
+
+    for (int g = 0; g < numGroups; ++g)
+        if (((mask >> (g * lanesPerGroup)) & laneMask) != 0)
+            newActiveGroups |= 1u << g;
+
+    // Grupos que voltam a ser usados começam do silêncio
+    for (int g = 0; g < numGroups; ++g)
+    {
+        const auto bit = 1u << g;
+        if ((newActiveGroups & bit) != 0 && (activeGroups & bit) == 0)
+            groups[(size_t) g].s1 = groups[(size_t) g].s2 = groups[(size_t) g].envelope = Lanes::expand(0.0f);
+    }
+
+    activeGroups = newActiveGroups;
+}
+
+void DynamicsDetector::process(const float* sidechain, int numSamples) noexcept
+{
+    const auto zero = Lanes::expand(0.0f);
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        if ((activeGroups & (1u << g)) == 0)
+            continue;
+
+        // Cópias locais para manter tudo em registradores durante o laço
+        auto& group = groups[(size_t) g];
+        const auto b0 = group.b0, b1 = group.b1, b2 = group.b2, a1 = group.a1, a2 = group.a2;
+        const auto attack = group.attack, release = group.release;
+        auto s1 = group.s1, s2 = group.s2, envelope = group.envelope;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = Lanes::expand(sidechain[i]);
+            const auto y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+
+            // Ataque quando a energia sobe, release quando desce, sem desvios
+            const auto delta = y * y - envelope;
+            envelope = envelope + attack * Lanes::max(delta, zero) + release * Lanes::min(delta, zero);
+        }
+
+        group.s1 = s1;
+        group.s2 = s2;
+        group.envelope = envelope;
+    }
+}
+
+float DynamicsDetector::getLevelDb(int band) const noexcept
+{
+    const float energy = getLane(groups[(size_t) (band / lanesPerGroup)].envelope, band % lanesPerGroup);
+    return 10.0f * std::log10(energy + 1.0e-12f);
+}
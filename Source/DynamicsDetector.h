@@ -0,0 +1,70 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include "BiquadCascade.h"
+
+//==============================================================================
+/** Detectores de nível das bandas dinâmicas.
+
+    Cada banda filtra o sidechain (a entrada do equalizador somada em mono)
+    com um passa-banda na frequência e no Q dela e segue a energia do
+    resultado com tempos de ataque e release separados. As bandas ocupam as
+    lanes de registradores SIMD, então todos os detectores avançam juntos,
+    amostra a amostra, em um único laço. O processador lê os níveis na taxa
+    de controle, na grade de atualização dos coeficientes.
+*/
+class DynamicsDetector
+{
+public:
+    static constexpr int maxBands = BiquadCascade<float>::maxSections;
+
+    void prepare(double sampleRate) noexcept;
+    void reset() noexcept;
+
+    // Passa-banda e tempos de uma banda; chamado só quando os parâmetros mudam
+    void setBand(int band, float freq, float q, float attackMs, float releaseMs) noexcept;
+
+    // Só os grupos de lanes com alguma banda ativa são processados
+    void setActiveBands(juce::uint32 mask) noexcept;
+
+    void process(const float* sidechain, int numSamples) noexcept;
+
+    // Nível da banda em dB (energia média da saída do passa-banda)
+    float getLevelDb(int band) const noexcept;
+
+private:
+    using Lanes = BiquadCascade<float>::Lanes;
+    static constexpr int lanesPerGroup = (int) Lanes::size();
+    static constexpr int numGroups = (maxBands + lanesPerGroup - 1) / lanesPerGroup;
+
+    struct Group
+    {
+        Lanes b0, b1, b2, a1, a2;      // passa-banda
+        Lanes s1, s2;                  // estado do passa-banda
+        Lanes envelope, attack, release;
+    };
+
+    static void setLane(Lanes& lanes, int lane, float value) noexcept;
+    static float getLane(const Lanes& lanes, int lane) noexcept;
+    float timeToCoefficient(float milliseconds) const noexcept;
+
+    std::array<Group, numGroups> groups;
+    juce::uint32 activeGroups = 0;
+    double sampleRate = 44100.0;
+};
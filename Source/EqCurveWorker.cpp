@@ -0,0 +1,71 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "EqCurveWorker.h"
+
+EqCurveWorker::EqCurveWorker(CurveProvider provider)
+    : juce::Thread("ParamEq Curve"),
+      curveProvider(std::move(provider))
+{
+}
+
+EqCurveWorker::~EqCurveWorker()
+{
+    stop();
+}
+
+void EqCurveWorker::addClient()
+{
+    if (numClients++ == 0)
+    {
+        // A curva publicada pode ter sido calculada antes da última mudança
+        updatePending = true;
+        startThread(juce::Thread::Priority::low);
+    }
+}
+
+void EqCurveWorker::removeClient()
+{
+    jassert(numClients > 0);
+
+    if (numClients > 0 && --numClients == 0)
+        stopThread(1000);
+}
+
+void EqCurveWorker::stop()
+{
+    numClients = 0;
+    stopThread(1000);
+}
+
+void EqCurveWorker::run()
+{
+    while (! threadShouldExit())
+    {
+        const int numPoints = requestedNumPoints.load();
+
+        // O pedido é consumido antes do cálculo: uma mudança que chegue
+        // durante ele gera outra curva na próxima volta
+        if (numPoints > 0 && (updatePending.exchange(false) || numPoints != publishedNumPoints))
+        {
+            auto curve = std::make_shared<const Curve>(curveProvider(numPoints));
+            std::atomic_store(&latestCurve, Snapshot(std::move(curve)));
+            publishedNumPoints = numPoints;
+        }
+
+        wait(pollIntervalMs);
+    }
+}
@@ -0,0 +1,79 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/** Thread que calcula a curva de equalização fora da thread de mensagens.
+
+    A thread verifica periodicamente se a curva foi marcada como desatualizada
+    ou se a largura pedida mudou; nesse caso calcula uma curva nova (a soma e
+    a contribuição de cada banda) e a publica como um snapshot imutável. Qualquer número de editores pode ler o
+    snapshot mais recente ao mesmo tempo; cada um fica com a sua referência
+    enquanto desenha, e a thread nunca altera um snapshot já publicado.
+*/
+class EqCurveWorker : private juce::Thread
+{
+public:
+    // Curvas em dB, uma posição por ponto
+    struct Curve
+    {
+        std::vector<float> total;
+        std::vector<std::vector<float>> bands;
+    };
+
+    using Snapshot = std::shared_ptr<const Curve>;
+
+    // Calcula a curva com o número de pontos dado; só é chamado pela thread
+    using CurveProvider = std::function<Curve(int numPoints)>;
+
+    explicit EqCurveWorker(CurveProvider provider);
+    ~EqCurveWorker() override;
+
+    // Cada editor se registra enquanto existir; a thread só roda com algum
+    // editor registrado. Devem ser chamados pela thread de mensagens
+    void addClient();
+    void removeClient();
+    void stop();
+
+    // Podem ser chamados de qualquer thread, inclusive a de áudio
+    void requestUpdate() noexcept { updatePending = true; }
+    void setNumPoints(int numPoints) noexcept { requestedNumPoints = juce::jmax(0, numPoints); }
+
+    // Curva mais recente, ou nullptr se nenhuma foi calculada ainda
+    Snapshot getLatestCurve() const noexcept { return std::atomic_load(&latestCurve); }
+
+private:
+    static constexpr int pollIntervalMs = 15;
+
+    void run() override;
+
+    CurveProvider curveProvider;
+
+    std::atomic<bool> updatePending { true };
+    std::atomic<int> requestedNumPoints { 0 };
+    int publishedNumPoints = 0; // só a thread usa
+    int numClients = 0;         // só a thread de mensagens usa
+
+    Snapshot latestCurve; // acessado apenas com std::atomic_load/atomic_store
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EqCurveWorker)
+};
@@ -0,0 +1,116 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "EqResponseEvaluator.h"
+#include <cmath>
+
+void EqResponseEvaluator::prepare(int newNumPoints, double newSampleRate, float newMinFreq, float newMaxFreq)
+{
+    newNumPoints = juce::jmax(2, newNumPoints);
+
+    if (newNumPoints == numPoints && newSampleRate == sampleRate
+        && newMinFreq == minFreq && newMaxFreq == maxFreq)
+        return;
+
+    numPoints = newNumPoints;
+    sampleRate = newSampleRate;
+    minFreq = newMinFreq;
+    maxFreq = newMaxFreq;
+
+    const auto size = static_cast<size_t>(numPoints);
+    cosW.resize(size);
+    cos2W.resize(size);
+    numerator.resize(size);
+    denominator.resize(size);
+    totalCurve.assign(size, 0.0f);
+
+    // Mesma distribuição logarítmica usada pela GUI
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const double freq = juce::mapToLog10(static_cast<double>(i) / (numPoints - 1),
+                                             static_cast<double>(minFreq), static_cast<double>(maxFreq));
+        const double w = juce::MathConstants<double>::twoPi * freq / sampleRate;
+        cosW[(size_t) i] = std::cos(w);
+        cos2W[(size_t) i] = std::cos(2.0 * w);
+    }
+
+    for (int band = 0; band < maxBands; ++band)
+        evaluateBand(band);
+
+    totalNeedsUpdate = true;
+}
+
+void EqResponseEvaluator::setBand(int band, const BiquadCoefficients& coeffs)
+{
+    jassert(juce::isPositiveAndBelow(band, maxBands));
+    auto& current = bandCoefficients[(size_t) band];
+
+    if (current.b0 == coeffs.b0 && current.b1 == coeffs.b1 && current.b2 == coeffs.b2
+        && current.a1 == coeffs.a1 && current.a2 == coeffs.a2 && ! bandCurves[(size_t) band].empty())
+        return;
+
+    current = coeffs;
+
+    if (numPoints > 0)
+    {
+        evaluateBand(band);
+        totalNeedsUpdate = true;
+    }
+}
+
+const std::vector<float>& EqResponseEvaluator::getTotalCurve()
+{
+    if (totalNeedsUpdate && numPoints > 0)
+    {
+        juce::FloatVectorOperations::copy(totalCurve.data(), bandCurves[0].data(), numPoints);
+        for (int band = 1; band < maxBands; ++band)
+            juce::FloatVectorOperations::add(totalCurve.data(), bandCurves[(size_t) band].data(), numPoints);
+
+        totalNeedsUpdate = false;
+    }
+
+    return totalCurve;
+}
+
+// |H(e^jw)|^2 = (n0 + n1 cos(w) + n2 cos(2w)) / (d0 + d1 cos(w) + d2 cos(2w))
+void EqResponseEvaluator::evaluateBand(int band)
+{
+    const auto& c = bandCoefficients[(size_t) band];
+    auto& curve = bandCurves[(size_t) band];
+    curve.resize(static_cast<size_t>(numPoints));
+
+    const double n0 = c.b0 * c.b0 + c.b1 * c.b1 + c.b2 * c.b2;
+    const double n1 = 2.0 * (c.b0 * c.b1 + c.b1 * c.b2);
+    const double n2 = 2.0 * c.b0 * c.b2;
+    const double d0 = 1.0 + c.a1 * c.a1 + c.a2 * c.a2;
+    const double d1 = 2.0 * (c.a1 + c.a1 * c.a2);
+    const double d2 = 2.0 * c.a2;
+
+    juce::FloatVectorOperations::fill(numerator.data(), n0, numPoints);
+    juce::FloatVectorOperations::addWithMultiply(numerator.data(), cosW.data(), n1, numPoints);
+    juce::FloatVectorOperations::addWithMultiply(numerator.data(), cos2W.data(), n2, numPoints);
+
+    juce::FloatVectorOperations::fill(denominator.data(), d0, numPoints);
+    juce::FloatVectorOperations::addWithMultiply(denominator.data(), cosW.data(), d1, numPoints);
+    juce::FloatVectorOperations::addWithMultiply(denominator.data(), cos2W.data(), d2, numPoints);
+
+    // 10 log10(|H|^2) = 20 log10(|H|), limitado a -200 dB como gainToDecibels
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const double ratio = juce::jmax(numerator[(size_t) i], 0.0) / juce::jmax(denominator[(size_t) i], 1.0e-30);
+        curve[(size_t) i] = static_cast<float>(juce::jmax(-200.0, 10.0 * std::log10(juce::jmax(ratio, 1.0e-20))));
+    }
+}
@@ -0,0 +1,64 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+#include "BiquadCascade.h"
+
+//==============================================================================
+/** Avalia a curva de resposta das bandas nos pontos da tela.
+
+    As tabelas de cos(w) e cos(2w) são calculadas uma vez por largura e taxa
+    de amostragem; a magnitude de cada banda sai de combinações lineares
+    dessas tabelas (FloatVectorOperations) e fica guardada em dB. Quando só
+    uma banda muda, apenas a curva dela é recalculada antes da soma.
+
+    Não é thread-safe: deve ser usado sempre pela mesma thread.
+*/
+class EqResponseEvaluator
+{
+public:
+    static constexpr int maxBands = BiquadCascade<float>::maxSections;
+
+    // Recalcula as tabelas se a largura ou a taxa mudaram
+    void prepare(int numPoints, double sampleRate, float minFreq = 20.0f, float maxFreq = 20000.0f);
+
+    // Atualiza a banda; a curva só é recalculada se os coeficientes mudaram
+    void setBand(int band, const BiquadCoefficients& coeffs);
+
+    // Curva em dB de uma banda e soma de todas
+    const std::vector<float>& getBandCurve(int band) const noexcept { return bandCurves[(size_t) band]; }
+    const std::vector<float>& getTotalCurve();
+
+    int getNumPoints() const noexcept { return numPoints; }
+
+private:
+    void evaluateBand(int band);
+
+    int numPoints = 0;
+    double sampleRate = 0.0;
+    float minFreq = 0.0f, maxFreq = 0.0f;
+
+    std::vector<double> cosW, cos2W;      // por ponto da tela
+    std::vector<double> numerator, denominator;
+
+    std::array<BiquadCoefficients, maxBands> bandCoefficients;
+    std::array<std::vector<float>, maxBands> bandCurves;
+    std::vector<float> totalCurve;
+    bool totalNeedsUpdate = true;
+};
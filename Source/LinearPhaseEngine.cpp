@@ -0,0 +1,279 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "LinearPhaseEngine.h"
+#include <cmath>
+
+namespace
+{
+    // Cabeça da partição não uniforme: o resto do kernel usa blocos maiores
+    constexpr int convolutionHeadSize = 256;
+}
+
+LinearPhaseEngine::LinearPhaseEngine(DesignProvider provider)
+    : juce::Thread("ParamEq Linear Phase"),
+      designProvider(std::move(provider))
+{
+}
+
+LinearPhaseEngine::~LinearPhaseEngine()
+{
+    stopThread(2000);
+}
+
+void LinearPhaseEngine::prepare(const juce::dsp::ProcessSpec& spec, bool buildNow)
+{
+    release();
+
+    sampleRate = spec.sampleRate;
+    maximumBlockSize = static_cast<int>(spec.maximumBlockSize);
+    numPreparedChannels = juce::jmin(static_cast<int>(spec.numChannels), BiquadCascade<float>::maxChannels);
+    prepared = true;
+
+    // Com o modo já ligado, os kernels saem prontos para o primeiro bloco,
+    // mesmo em renderização offline
+    if (buildNow)
+    {
+        createResources();
+        startThread(juce::Thread::Priority::low);
+    }
+}
+
+void LinearPhaseEngine::release()
+{
+    stopThread(2000);
+    resourcesReady = false;
+    prepared = false;
+    convolutions.clear();
+    loadQueue.reset();
+    conversionBuffer.setSize(0, 0);
+}
+
+void LinearPhaseEngine::ensureResources()
+{
+    if (prepared && ! isThreadRunning())
+        startThread(juce::Thread::Priority::low);
+}
+
+// Cria a fila, as convoluções e os primeiros kernels. Os kernels carregados
+// antes de prepare entram sem crossfade; a thread de áudio só usa as
+// convoluções depois que resourcesReady é publicado
+void LinearPhaseEngine::createResources()
+{
+    if (resourcesReady.load())
+        return;
+
+    loadQueue = std::make_unique<juce::dsp::ConvolutionMessageQueue>();
+
+    convolutions.clear();
+    for (int ch = 0; ch < numPreparedChannels; ch += 2)
+        convolutions.push_back(std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::NonUniform { convolutionHeadSize }, *loadQueue));
+
+    conversionBuffer.setSize(juce::jmax(1, numPreparedChannels), juce::jmax(1, maximumBlockSize));
+
+    kernelUpdatePending = false;
+    buildAndLoadKernels();
+
+    for (size_t i = 0; i < convolutions.size(); ++i)
+    {
+        const int numChannels = juce::jmin(2, numPreparedChannels - static_cast<int>(i) * 2);
+        convolutions[i]->prepare({ sampleRate, static_cast<juce::uint32>(maximumBlockSize), static_cast<juce::uint32>(numChannels) });
+    }
+
+    resourcesReady.store(true, std::memory_order_release);
+}
+
+void LinearPhaseEngine::reset() noexcept
+{
+    if (! isReady())
+        return;
+
+    for (auto& convolution : convolutions)
+        convolution->reset();
+}
+
+int LinearPhaseEngine::getLatencySamples(int lengthIndex) const noexcept
+{
+    // A partição não uniforme não acrescenta latência, então o valor é o
+    // mesmo antes e depois de os recursos existirem
+    const int convolutionLatency = isReady() && ! convolutions.empty() ? convolutions.front()->getLatency() : 0;
+    return convolutionLatency + getKernelLength(lengthIndex) / 2;
+}
+
+void LinearPhaseEngine::run()
+{
+    // Na primeira ativação depois de prepare a própria thread cria os
+    // recursos. Pedidos feitos enquanto o modo está desligado ficam
+    // pendentes até que ele seja ligado
+    createResources();
+
+    while (! threadShouldExit())
+    {
+        if (active.load() && kernelUpdatePending.exchange(false))
+            buildAndLoadKernels();
+
+        wait(20);
+    }
+}
+
+// Monta um kernel por canal (canais com as mesmas bandas compartilham o
+// mesmo kernel) e entrega cada par de canais à sua convolução
+void LinearPhaseEngine::buildAndLoadKernels()
+{
+    if (convolutions.empty())
+        return;
+
+    const auto design = designProvider();
+    const int length = getKernelLength(design.kernelLengthIndex);
+    const double designRate = sampleRate * design.designOversampling;
+
+    std::array<BiquadCoefficients, maxBands> coefficients;
+    for (int band = 0; band < maxBands; ++band)
+    {
+        const auto& b = design.bands[(size_t) band];
+        coefficients[(size_t) band] = CoefficientDesigner::design(b.type, designRate, b.freq, b.q, b.gainDb, design.method);
+    }
+
+    std::vector<juce::uint32> channelMasks;
+    std::vector<std::vector<float>> kernels;
+    std::vector<BiquadCoefficients> sections;
+
+    auto getKernelForChannel = [&](int channel) -> const std::vector<float>&
+    {
+        juce::uint32 mask = 0;
+        for (int band = 0; band < maxBands; ++band)
+        {
+            const int bandChannel = design.bands[(size_t) band].channel;
+            if (bandChannel == BiquadCascade<float>::allChannels || bandChannel == channel)
+                mask |= 1u << band;
+        }
+
+        for (size_t i = 0; i < channelMasks.size(); ++i)
+            if (channelMasks[i] == mask)
+                return kernels[i];
+
+        sections.clear();
+        for (int band = 0; band < maxBands; ++band)
+            if ((mask & (1u << band)) != 0)
+                sections.push_back(coefficients[(size_t) band]);
+
+        channelMasks.push_back(mask);
+        kernels.emplace_back(static_cast<size_t>(length));
+        buildKernel(sections, designRate, kernels.back().data(), length);
+        return kernels.back();
+    };
+
+    for (size_t i = 0; i < convolutions.size(); ++i)
+    {
+        const int firstChannel = static_cast<int>(i) * 2;
+        const int numChannels = juce::jmin(2, numPreparedChannels - firstChannel);
+
+        juce::AudioBuffer<float> impulseResponse(numChannels, length);
+        for (int ch = 0; ch < numChannels; ++ch)
+            impulseResponse.copyFrom(ch, 0, getKernelForChannel(firstChannel + ch).data(), length);
+
+        convolutions[i]->loadImpulseResponse(std::move(impulseResponse), sampleRate,
+                                             numChannels == 2 ? juce::dsp::Convolution::Stereo::yes : juce::dsp::Convolution::Stereo::no,
+                                             juce::dsp::Convolution::Trim::no,
+                                             juce::dsp::Convolution::Normalise::no);
+    }
+
+    ++kernelsBuilt;
+}
+
+// Magnitude da cascata -> IFFT com fase zero -> deslocamento de N/2 -> janela
+void LinearPhaseEngine::buildKernel(const std::vector<BiquadCoefficients>& sections, double designRate, float* kernel, int length)
+{
+    const int order = juce::roundToInt(std::log2(static_cast<double>(length)));
+    juce::dsp::FFT inverseFFT(order);
+    std::vector<float> spectrum(static_cast<size_t>(length * 2), 0.0f);
+
+    for (int bin = 0; bin <= length / 2; ++bin)
+    {
+        const double freq = bin * sampleRate / length;
+        double magnitude = 1.0;
+
+        for (const auto& section : sections)
+            magnitude *= CoefficientDesigner::getMagnitudeForFrequency(section, freq, designRate);
+
+        spectrum[(size_t) bin * 2] = static_cast<float>(magnitude);
+    }
+
+    inverseFFT.performRealOnlyInverseTransform(spectrum.data());
+
+    // A resposta de fase zero fica centrada em 0; o deslocamento circular a
+    // centra em N/2. A janela Blackman-Harris periódica é simétrica em torno
+    // do mesmo ponto, então o kernel continua simétrico
+    const double twoPiOverN = juce::MathConstants<double>::twoPi / length;
+
+    for (int n = 0; n < length; ++n)
+    {
+        const double w = 0.35875 - 0.48829 * std::cos(twoPiOverN * n)
+                       + 0.14128 * std::cos(2.0 * twoPiOverN * n) - 0.01168 * std::cos(3.0 * twoPiOverN * n);
+        kernel[n] = static_cast<float>(spectrum[(size_t) ((n + length / 2) % length)] * w);
+    }
+}
+
+void LinearPhaseEngine::process(float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (! isReady())
+        return;
+
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+
+    for (int start = 0; start < numSamples; start += maximumBlockSize)
+    {
+        const int chunkSize = juce::jmin(maximumBlockSize, numSamples - start);
+
+        for (size_t i = 0; i < convolutions.size(); ++i)
+        {
+            const int firstChannel = static_cast<int>(i) * 2;
+            if (firstChannel >= numChannels)
+                break;
+
+            juce::dsp::AudioBlock<float> block(channels + firstChannel,
+                                               static_cast<size_t>(juce::jmin(2, numChannels - firstChannel)),
+                                               static_cast<size_t>(start), static_cast<size_t>(chunkSize));
+            convolutions[i]->process(juce::dsp::ProcessContextReplacing<float>(block));
+        }
+    }
+}
+
+// A convolução da JUCE só trabalha em float: o caminho em double converte
+// em blocos pelo buffer preparado
+void LinearPhaseEngine::process(double* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (! isReady())
+        return;
+
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+    auto* const* floatChannels = conversionBuffer.getArrayOfWritePointers();
+
+    for (int start = 0; start < numSamples; start += maximumBlockSize)
+    {
+        const int chunkSize = juce::jmin(maximumBlockSize, numSamples - start);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < chunkSize; ++i)
+                floatChannels[ch][i] = static_cast<float>(channels[ch][start + i]);
+
+        process(floatChannels, numChannels, chunkSize);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < chunkSize; ++i)
+                channels[ch][start + i] = floatChannels[ch][i];
+    }
+}
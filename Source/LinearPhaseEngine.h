@@ -0,0 +1,123 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "BiquadCascade.h"
+#include "CoefficientDesigner.h"
+
+//==============================================================================
+/** Modo de fase linear: aplica a resposta de magnitude das bandas como um
+    filtro FIR simétrico.
+
+    Uma thread em segundo plano amostra a magnitude da cascata em N/2 + 1
+    frequências, faz a IFFT com fase zero, centraliza o resultado e aplica
+    uma janela Blackman-Harris. O kernel é aplicado com juce::dsp::Convolution
+    (partição não uniforme), uma instância por par de canais, e cada kernel
+    novo entra com o crossfade da própria Convolution.
+
+    A latência é a da convolução mais N/2 amostras.
+
+    Nada disso existe enquanto o modo não é usado: a fila de carga, as
+    convoluções e a thread de construção só são criadas na primeira
+    ativação depois de prepare (ou já em prepare, se o modo estiver ligado).
+*/
+class LinearPhaseEngine : private juce::Thread
+{
+public:
+    static constexpr int numKernelLengths = 4;
+    static constexpr int maxBands = BiquadCascade<float>::maxSections;
+
+    // Uma banda como a thread de áudio a vê; bandas com o mesmo canal
+    // (ou allChannels) formam o kernel de cada canal
+    struct Band
+    {
+        FilterType type = PEAK;
+        float freq = 1000.0f, q = 1.0f, gainDb = 0.0f;
+        int channel = BiquadCascade<float>::allChannels;
+    };
+
+    struct Design
+    {
+        std::array<Band, maxBands> bands;
+        int kernelLengthIndex = 1;
+        double designOversampling = 1.0; // projeta as bandas como a cascata sobreamostrada
+        DesignMethod method = BILINEAR;
+    };
+
+    // Chamado pela thread de construção para ler os parâmetros atuais;
+    // deve ser seguro em qualquer thread
+    using DesignProvider = std::function<Design()>;
+
+    explicit LinearPhaseEngine(DesignProvider provider);
+    ~LinearPhaseEngine() override;
+
+    static int getKernelLength(int lengthIndex) noexcept { return 4096 << juce::jlimit(0, numKernelLengths - 1, lengthIndex); }
+
+    // Guarda a configuração; com buildNow constrói os kernels atuais de
+    // forma síncrona, prepara as convoluções e inicia a thread. Deve ser
+    // chamado fora da thread de áudio
+    void prepare(const juce::dsp::ProcessSpec& spec, bool buildNow);
+    void release();
+
+    // Inicia a thread, que cria as convoluções e os kernels; chamado fora
+    // da thread de áudio quando o modo é ligado. Até isReady, process não
+    // faz nada
+    void ensureResources();
+    bool isReady() const noexcept { return resourcesReady.load(std::memory_order_acquire); }
+    void reset() noexcept;
+
+    // Apenas marcam o pedido; a thread de construção o atende
+    void requestKernelUpdate() noexcept { kernelUpdatePending = true; }
+    void setActive(bool shouldBeActive) noexcept { active = shouldBeActive; }
+
+    int getLatencySamples(int lengthIndex) const noexcept;
+    bool isKernelReady() const noexcept { return kernelsBuilt.load() > 0; }
+
+    // Processa numSamples amostras de cada canal
+    void process(float* const* channels, int numChannels, int numSamples) noexcept;
+    void process(double* const* channels, int numChannels, int numSamples) noexcept;
+
+private:
+    void run() override;
+    void createResources();
+    void buildAndLoadKernels();
+    void buildKernel(const std::vector<BiquadCoefficients>& sections, double designRate, float* kernel, int length);
+
+    DesignProvider designProvider;
+
+    double sampleRate = 44100.0;
+    int maximumBlockSize = 0;
+    int numPreparedChannels = 0;
+
+    bool prepared = false;
+
+    std::unique_ptr<juce::dsp::ConvolutionMessageQueue> loadQueue; // compartilhada pelas convoluções
+    std::vector<std::unique_ptr<juce::dsp::Convolution>> convolutions; // uma por par de canais
+    juce::AudioBuffer<float> conversionBuffer; // caminho em double
+
+    std::atomic<bool> kernelUpdatePending { false };
+    std::atomic<bool> active { false };
+    std::atomic<bool> resourcesReady { false };
+    std::atomic<int> kernelsBuilt { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhaseEngine)
+};
@@ -0,0 +1,223 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "PerformanceTelemetry.h"
+
+#if PARAMEQ_ENABLE_TELEMETRY
+
+//==============================================================================
+void TelemetryHistogram::record(double value) noexcept
+{
+    value = juce::jmax(0.0, value);
+
+    int bucket = 0;
+    if (scale == Scale::log2)
+        bucket = value >= 1.0 ? (int) std::floor(std::log2(value)) : 0;
+    else
+        bucket = (int) (value / bucketWidth);
+
+    buckets[(size_t) juce::jlimit(0, numBuckets - 1, bucket)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    // Escritor único: leitura e escrita separadas bastam
+    sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+
+    if (value > maximum.load(std::memory_order_relaxed))
+        maximum.store(value, std::memory_order_relaxed);
+}
+
+TelemetryHistogram::Snapshot TelemetryHistogram::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+
+    for (size_t i = 0; i < buckets.size(); ++i)
+        snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+
+    snapshot.count = count.load(std::memory_order_relaxed);
+    snapshot.sum = sum.load(std::memory_order_relaxed);
+    snapshot.maximum = maximum.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void TelemetryHistogram::reset() noexcept
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0.0, std::memory_order_relaxed);
+    maximum.store(0.0, std::memory_order_relaxed);
+}
+
+double TelemetryHistogram::getBucketStart(int bucket) const noexcept
+{
+    if (scale == Scale::log2)
+        return bucket == 0 ? 0.0 : std::ldexp(1.0, bucket);
+
+    return bucket * bucketWidth;
+}
+
+// Limite superior do balde em que cai a fração pedida das amostras
+double TelemetryHistogram::Snapshot::getPercentile(double fraction, Scale scale, double width) const noexcept
+{
+    juce::uint64 total = 0;
+    for (auto bucketCount : buckets)
+        total += bucketCount;
+
+    if (total == 0)
+        return 0.0;
+
+    const auto target = (juce::uint64) std::ceil(fraction * (double) total);
+    juce::uint64 accumulated = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        accumulated += buckets[(size_t) i];
+
+        if (accumulated >= target)
+            return scale == Scale::log2 ? std::ldexp(1.0, i + 1) : (i + 1) * width;
+    }
+
+    return maximum;
+}
+
+//==============================================================================
+void PerformanceTelemetry::recordBlock(juce::int64 elapsedTicks, int numSamples, double sampleRate,
+                                       int numProcessedBands, int numSkippedBands) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const double nanoseconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks) * 1.0e9;
+    const double deadline = sampleRate > 0.0 ? numSamples / sampleRate * 1.0e9 : 0.0;
+
+    blockNanoseconds.record(nanoseconds);
+    nanosecondsPerSample.record(nanoseconds / numSamples);
+
+    if (deadline > 0.0)
+    {
+        blockLoadPercent.record(100.0 * nanoseconds / deadline);
+
+        if (nanoseconds > deadline)
+            add(deadlineOverruns);
+    }
+
+    add(blocks);
+    add(processedBands, (juce::uint64) numProcessedBands);
+    add(skippedBands, (juce::uint64) numSkippedBands);
+}
+
+void PerformanceTelemetry::recordCoefficientUpdate(int band) noexcept
+{
+    if (juce::isPositiveAndBelow(band, maxBands))
+        add(coefficientUpdates[(size_t) band]);
+}
+
+void PerformanceTelemetry::recordAnalyzerPush(int numPushed, int numRequested) noexcept
+{
+    add(analyzerPushes);
+
+    if (numPushed < numRequested)
+        add(analyzerDroppedSamples, (juce::uint64) (numRequested - numPushed));
+}
+
+PerformanceTelemetry::Snapshot PerformanceTelemetry::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+    snapshot.blockNanoseconds = blockNanoseconds.getSnapshot();
+    snapshot.nanosecondsPerSample = nanosecondsPerSample.getSnapshot();
+    snapshot.blockLoadPercent = blockLoadPercent.getSnapshot();
+
+    for (size_t band = 0; band < coefficientUpdates.size(); ++band)
+        snapshot.coefficientUpdates[band] = coefficientUpdates[band].load(std::memory_order_relaxed);
+
+    snapshot.blocks = blocks.load(std::memory_order_relaxed);
+    snapshot.deadlineOverruns = deadlineOverruns.load(std::memory_order_relaxed);
+    snapshot.processedBands = processedBands.load(std::memory_order_relaxed);
+    snapshot.skippedBands = skippedBands.load(std::memory_order_relaxed);
+    snapshot.analyzerPushes = analyzerPushes.load(std::memory_order_relaxed);
+    snapshot.analyzerDroppedSamples = analyzerDroppedSamples.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+// Pode correr junto com a thread de áudio; um bloco registrado durante o
+// reset pode ficar parcialmente contado
+void PerformanceTelemetry::reset() noexcept
+{
+    blockNanoseconds.reset();
+    nanosecondsPerSample.reset();
+    blockLoadPercent.reset();
+
+    for (auto& counter : coefficientUpdates)
+        counter.store(0, std::memory_order_relaxed);
+
+    for (auto* counter : { &blocks, &deadlineOverruns, &processedBands, &skippedBands, &analyzerPushes, &analyzerDroppedSamples })
+        counter->store(0, std::memory_order_relaxed);
+}
+
+juce::var PerformanceTelemetry::toVar() const
+{
+    const auto snapshot = getSnapshot();
+
+    auto histogramToVar = [](const TelemetryHistogram& histogram, const TelemetryHistogram::Snapshot& data) {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("count", (juce::int64) data.count);
+        object->setProperty("mean", data.getMean());
+        object->setProperty("max", data.maximum);
+        object->setProperty("p50", data.getPercentile(0.50, histogram.getScale(), histogram.getBucketWidth()));
+        object->setProperty("p99", data.getPercentile(0.99, histogram.getScale(), histogram.getBucketWidth()));
+
+        juce::Array<juce::var> buckets;
+        for (int i = 0; i < TelemetryHistogram::numBuckets; ++i)
+        {
+            if (data.buckets[(size_t) i] == 0)
+                continue;
+
+            auto* bucket = new juce::DynamicObject();
+            bucket->setProperty("from", histogram.getBucketStart(i));
+            bucket->setProperty("count", (juce::int64) data.buckets[(size_t) i]);
+            buckets.add(juce::var(bucket));
+        }
+
+        object->setProperty("buckets", buckets);
+        return juce::var(object);
+    };
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("blocks", (juce::int64) snapshot.blocks);
+    result->setProperty("deadlineOverruns", (juce::int64) snapshot.deadlineOverruns);
+    result->setProperty("blockNs", histogramToVar(blockNanoseconds, snapshot.blockNanoseconds));
+    result->setProperty("nsPerSample", histogramToVar(nanosecondsPerSample, snapshot.nanosecondsPerSample));
+    result->setProperty("blockLoadPercent", histogramToVar(blockLoadPercent, snapshot.blockLoadPercent));
+    result->setProperty("processedBands", (juce::int64) snapshot.processedBands);
+    result->setProperty("skippedBands", (juce::int64) snapshot.skippedBands);
+    result->setProperty("analyzerPushes", (juce::int64) snapshot.analyzerPushes);
+    result->setProperty("analyzerDroppedSamples", (juce::int64) snapshot.analyzerDroppedSamples);
+
+    juce::Array<juce::var> updates;
+    for (auto bandUpdates : snapshot.coefficientUpdates)
+        updates.add((juce::int64) bandUpdates);
+    result->setProperty("coefficientUpdatesPerBand", updates);
+
+    return juce::var(result);
+}
+
+bool PerformanceTelemetry::writeToFile(const juce::File& file) const
+{
+    return file.replaceWithText(juce::JSON::toString(toVar()));
+}
+
+#endif
@@ -0,0 +1,143 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+// Definido pelo CMake (opção PARAMEQ_ENABLE_TELEMETRY); desligado, nenhuma
+// instrumentação é compilada
+#ifndef PARAMEQ_ENABLE_TELEMETRY
+ #define PARAMEQ_ENABLE_TELEMETRY 0
+#endif
+
+#if PARAMEQ_ENABLE_TELEMETRY
+ #define PARAMEQ_TELEMETRY(statement) statement
+#else
+ #define PARAMEQ_TELEMETRY(statement)
+#endif
+
+#if PARAMEQ_ENABLE_TELEMETRY
+
+//==============================================================================
+/** Histograma de baldes fixos alimentado pela thread de áudio.
+
+    Cada registro é um fetch_add relaxado; não há locks nem alocação. Com
+    escala log2, o balde n > 0 conta valores em [2^n, 2^(n+1)) e o balde 0
+    tudo abaixo de 2, ou seja [0, 2); com escala linear, valores em
+    [n * largura, (n + 1) * largura). O último balde acumula tudo o que
+    passar do limite.
+*/
+class TelemetryHistogram
+{
+public:
+    static constexpr int numBuckets = 32;
+
+    enum class Scale { log2, linear };
+
+    struct Snapshot
+    {
+        std::array<juce::uint64, numBuckets> buckets {};
+        juce::uint64 count = 0;
+        double sum = 0.0;
+        double maximum = 0.0;
+
+        double getMean() const noexcept { return count > 0 ? sum / (double) count : 0.0; }
+        double getPercentile(double fraction, Scale scale, double bucketWidth) const noexcept;
+    };
+
+    explicit TelemetryHistogram(Scale s, double linearBucketWidth = 1.0) noexcept
+        : scale(s), bucketWidth(linearBucketWidth) {}
+
+    void record(double value) noexcept;
+    Snapshot getSnapshot() const noexcept;
+    void reset() noexcept;
+
+    // Limite inferior do balde, na unidade dos valores registrados
+    double getBucketStart(int bucket) const noexcept;
+
+    Scale getScale() const noexcept { return scale; }
+    double getBucketWidth() const noexcept { return bucketWidth; }
+
+private:
+    const Scale scale;
+    const double bucketWidth;
+
+    std::array<std::atomic<juce::uint64>, numBuckets> buckets {};
+    std::atomic<juce::uint64> count { 0 };
+    std::atomic<double> sum { 0.0 };     // só a thread de áudio escreve
+    std::atomic<double> maximum { 0.0 };
+};
+
+//==============================================================================
+/** Medições de desempenho de processBlock.
+
+    A thread de áudio registra tempo de bloco, ns por amostra, carga em
+    relação à duração do bloco, recálculos de coeficientes por banda,
+    bandas processadas e puladas e envios ao analisador. Qualquer thread
+    pode ler um snapshot (para o overlay do editor) ou gravá-lo em JSON.
+*/
+class PerformanceTelemetry
+{
+public:
+    static constexpr int maxBands = 8;
+
+    struct Snapshot
+    {
+        TelemetryHistogram::Snapshot blockNanoseconds, nanosecondsPerSample, blockLoadPercent;
+        std::array<juce::uint64, maxBands> coefficientUpdates {};
+        juce::uint64 blocks = 0;
+        juce::uint64 deadlineOverruns = 0;
+        juce::uint64 processedBands = 0;
+        juce::uint64 skippedBands = 0;
+        juce::uint64 analyzerPushes = 0;
+        juce::uint64 analyzerDroppedSamples = 0;
+    };
+
+    //=========================== Thread de áudio =============================
+    void recordBlock(juce::int64 elapsedTicks, int numSamples, double sampleRate, int numProcessedBands, int numSkippedBands) noexcept;
+    void recordCoefficientUpdate(int band) noexcept;
+    void recordAnalyzerPush(int numPushed, int numRequested) noexcept;
+
+    //=========================== Qualquer thread =============================
+    Snapshot getSnapshot() const noexcept;
+    void reset() noexcept;
+
+    juce::var toVar() const;
+    bool writeToFile(const juce::File& file) const;
+
+private:
+    static void add(std::atomic<juce::uint64>& counter, juce::uint64 amount = 1) noexcept
+    {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    // Tempos em ns (log2); carga em % da duração do bloco, baldes de 10%
+    TelemetryHistogram blockNanoseconds { TelemetryHistogram::Scale::log2 };
+    TelemetryHistogram nanosecondsPerSample { TelemetryHistogram::Scale::log2 };
+    TelemetryHistogram blockLoadPercent { TelemetryHistogram::Scale::linear, 10.0 };
+
+    std::array<std::atomic<juce::uint64>, maxBands> coefficientUpdates {};
+    std::atomic<juce::uint64> blocks { 0 };
+    std::atomic<juce::uint64> deadlineOverruns { 0 };
+    std::atomic<juce::uint64> processedBands { 0 };
+    std::atomic<juce::uint64> skippedBands { 0 };
+    std::atomic<juce::uint64> analyzerPushes { 0 };
+    std::atomic<juce::uint64> analyzerDroppedSamples { 0 };
+};
+
+#endif
@@ -122,15 +122,12 @@ ParamEqAudioProcessorEditor::ParamEqAudioProcessorEditor (ParamEqAudioProcessor&
     // === Analisador de espectro ===
     spectrumAnalyzer = std::make_unique<SpectrumAnalyzer>(audioProcessor);
     addAndMakeVisible(spectrumAnalyzer.get());
-    audioProcessor.spectrumAnalyzer = spectrumAnalyzer.get();
 
     setSize(1000, 500);
 }
 
 
 ParamEqAudioProcessorEditor::~ParamEqAudioProcessorEditor() {
-    audioProcessor.spectrumAnalyzer = nullptr; // Limpa o ponteiro do analisador de espectro
-    
     // Limpa os Look and Feel para evitar vazamentos de memória
     for (int band = 0; band < ParamEqAudioProcessor::NUM_BANDS; ++band) {
     freqSliders[band].setLookAndFeel(nullptr);
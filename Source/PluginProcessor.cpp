@@ -29,6 +29,22 @@ juce::String ParamEqAudioProcessor::getFilterTypeName(FilterType type) {
     }
 }
 
+juce::String ParamEqAudioProcessor::getBandParameterID(BandParameter parameter, int band) {
+    switch (parameter) {
+        case BAND_FREQ: return "FREQ" + juce::String(band + 1);
+        case BAND_GAIN: return "GAIN" + juce::String(band + 1);
+        case BAND_Q:    return "Q" + juce::String(band + 1);
+        case BAND_TYPE: return "TYPE" + juce::String(band + 1);
+        case BAND_CHANNEL: return "CHAN" + juce::String(band + 1);
+        case BAND_DYNAMIC: return "DYN" + juce::String(band + 1);
+        case BAND_THRESHOLD: return "THRESH" + juce::String(band + 1);
+        case BAND_RATIO: return "RATIO" + juce::String(band + 1);
+        case BAND_ATTACK: return "ATTACK" + juce::String(band + 1);
+        case BAND_RELEASE: return "RELEASE" + juce::String(band + 1);
+        default:        return {};
+    }
+}
+
 //=================================== Construtor/Destrutor ===========================================
 ParamEqAudioProcessor::ParamEqAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -43,26 +59,80 @@ ParamEqAudioProcessor::ParamEqAudioProcessor()
 #endif
     parameters(*this, nullptr, "Params", createParameterLayout())
 {
-    // Inicialize os filtros (mantenha o existente)
-    filters.resize(NUM_BANDS);
-    
     // Inicialize valores anteriores para otimização
     for (auto& val : lastFreq) val.store(-1.0f);
     for (auto& val : lastQ) val.store(-1.0f);
     for (auto& val : lastGain) val.store(-1.0f);
     for (auto& type : filterTypes) type = PEAK;
     for (auto& lastType : lastFilterType) lastType = PEAK;
+    for (auto& dirty : coefficientsDirty) dirty = true;
+
+    // Monta a tabela de parâmetros uma única vez; daqui em diante a thread
+    // de áudio acessa os valores apenas por índice
+    parameterIndexToBand.assign(static_cast<size_t>(getParameters().size()), -1);
+    parameterIndexToBandParameter.assign(static_cast<size_t>(getParameters().size()), -1);
+    parameterAffectsShape.assign(static_cast<size_t>(getParameters().size()), false);
 
     for (int band = 0; band < NUM_BANDS; ++band)
     {
-        auto markDirty = [this, band](float) { coefficientsDirty[band] = true;};
+        for (int p = 0; p < NUM_BAND_PARAMETERS; ++p)
+        {
+            const auto id = getBandParameterID(static_cast<BandParameter>(p), band);
+            auto* param = parameters.getParameter(id);
+            jassert(param != nullptr);
+
+            bandParameterValues[band][p] = parameters.getRawParameterValue(id)->load();
+            bandStateIndices[band][p] = param->getParameterIndex();
+            parameterIndexToBand[static_cast<size_t>(param->getParameterIndex())] = band;
+            parameterIndexToBandParameter[static_cast<size_t>(param->getParameterIndex())] = p;
+            parameterAffectsShape[static_cast<size_t>(param->getParameterIndex())] = p == BAND_FREQ || p == BAND_GAIN || p == BAND_Q
+                                                                                   || p == BAND_TYPE || p == BAND_CHANNEL;
+            param->addListener(this);
+        }
+
+        bandParams[band] = readBandParams(band);
+    }
+
+    oversamplingParameter = parameters.getRawParameterValue(OVERSAMPLING_ID);
+    phaseModeParameter = parameters.getRawParameterValue(PHASE_MODE_ID);
+    linearPhaseLengthParameter = parameters.getRawParameterValue(LINEAR_PHASE_LENGTH_ID);
+    designMethodParameter = parameters.getRawParameterValue(DESIGN_METHOD_ID);
+    jassert(oversamplingParameter != nullptr && phaseModeParameter != nullptr
+            && linearPhaseLengthParameter != nullptr && designMethodParameter != nullptr);
+    designMethod = getDesignMethodParameter();
+
+    // Handles do estado, na ordem do layout; estados e bancos guardam os IDs
+    // dessa ordem e são restaurados por ID
+    for (auto* parameter : getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        jassert(ranged != nullptr);
 
-        parameters.getParameter("FREQ" + juce::String(band + 1))->addListener(this);
-        parameters.getParameter("Q" + juce::String(band + 1))->addListener(this);
-        parameters.getParameter("GAIN" + juce::String(band + 1))->addListener(this);
-        parameters.getParameter("TYPE" + juce::String(band + 1))->addListener(this);
+        stateParameters.push_back(ranged);
+        stateValueHandles.push_back(parameters.getRawParameterValue(ranged->getParameterID()));
+        stateParameterIDs.add(ranged->getParameterID());
+        stateDefaultValues.push_back(ranged->convertFrom0to1(ranged->getDefaultValue()));
     }
 
+    // A versão 1 do formato guardava só o hash: o layout atual e o anterior
+    // às bandas dinâmicas são reconhecidos por ele
+    juce::StringArray preDynamicsIDs;
+    for (int band = 0; band < NUM_BANDS; ++band)
+        for (auto parameter : { BAND_FREQ, BAND_GAIN, BAND_Q, BAND_TYPE, BAND_CHANNEL })
+            preDynamicsIDs.add(getBandParameterID(parameter, band));
+    for (auto* id : { OVERSAMPLING_ID, PHASE_MODE_ID, LINEAR_PHASE_LENGTH_ID, DESIGN_METHOD_ID })
+        preDynamicsIDs.add(id);
+
+    knownStateLayouts = { stateParameterIDs, preDynamicsIDs };
+
+    oversamplingStateIndex = parameters.getParameter(OVERSAMPLING_ID)->getParameterIndex();
+    designMethodStateIndex = parameters.getParameter(DESIGN_METHOD_ID)->getParameterIndex();
+
+    // O banco padrão, se existir, fornece os programas do host
+    presetBank.open(getDefaultPresetBankFile(), knownStateLayouts);
+
+    resetSmoothers(44100.0);
+
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout ParamEqAudioProcessor::createParameterLayout()
@@ -73,7 +143,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout ParamEqAudioProcessor::creat
     {
         // Parâmetro de frequência
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            "FREQ" + juce::String(band + 1),
+            getBandParameterID(BAND_FREQ, band),
             "Frequency " + juce::String(band + 1),
             juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.25f),
             1000.0f
@@ -81,7 +151,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout ParamEqAudioProcessor::creat
 
         // Parâmetro de ganho
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            "GAIN" + juce::String(band + 1),
+            getBandParameterID(BAND_GAIN, band),
             "Gain " + juce::String(band + 1),
             juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f),
             0.0f
@@ -89,7 +159,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout ParamEqAudioProcessor::creat
 
         // Parâmetro de Q
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            "Q" + juce::String(band + 1),
+            getBandParameterID(BAND_Q, band),
             "Q " + juce::String(band + 1),
             juce::NormalisableRange<float>(0.1f, 7.0f, 0.01f),
             1.0f
@@ -97,20 +167,106 @@ juce::AudioProcessorValueTreeState::ParameterLayout ParamEqAudioProcessor::creat
 
         // Parâmetro de tipo de filtro
         params.push_back(std::make_unique<juce::AudioParameterChoice>(
-            "TYPE" + juce::String(band + 1),
+            getBandParameterID(BAND_TYPE, band),
             "Filter Type " + juce::String(band + 1),
             juce::StringArray({"Peak", "Low Shelf", "High Shelf", "Low Pass", "High Pass"}),
             0 // Valor padrão: Peak
         ));
+
+        // Canal afetado pela banda: todos (EQ ligado) ou um canal específico
+        juce::StringArray channelChoices { "All" };
+        for (int ch = 1; ch <= BiquadCascade<float>::maxChannels; ++ch)
+            channelChoices.add(juce::String(ch));
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            getBandParameterID(BAND_CHANNEL, band),
+            "Channel " + juce::String(band + 1),
+            channelChoices,
+            0 // Valor padrão: todos os canais
+        ));
+
+        // Dinâmica da banda: com o nível da banda acima do limiar, o ganho
+        // cai (acima do limiar) / razão, como em um compressor
+        params.push_back(std::make_unique<juce::AudioParameterBool>(
+            getBandParameterID(BAND_DYNAMIC, band),
+            "Dynamic " + juce::String(band + 1),
+            false
+        ));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            getBandParameterID(BAND_THRESHOLD, band),
+            "Threshold " + juce::String(band + 1),
+            juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f),
+            -24.0f
+        ));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            getBandParameterID(BAND_RATIO, band),
+            "Ratio " + juce::String(band + 1),
+            juce::NormalisableRange<float>(1.0f, 10.0f, 0.1f, 0.5f),
+            2.0f
+        ));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            getBandParameterID(BAND_ATTACK, band),
+            "Attack " + juce::String(band + 1),
+            juce::NormalisableRange<float>(0.1f, 200.0f, 0.1f, 0.3f),
+            10.0f
+        ));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            getBandParameterID(BAND_RELEASE, band),
+            "Release " + juce::String(band + 1),
+            juce::NormalisableRange<float>(5.0f, 2000.0f, 1.0f, 0.3f),
+            100.0f
+        ));
     }
 
+    // Sobreamostragem em volta de toda a cascata: reduz a compressão das
+    // curvas perto de Nyquist causada pela transformada bilinear
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        OVERSAMPLING_ID,
+        "Oversampling",
+        juce::StringArray({"1x", "2x", "4x", "8x"}),
+        0 // Valor padrão: sem sobreamostragem
+    ));
+
+    // Fase mínima (cascata IIR) ou fase linear (convolução com kernel FIR)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        PHASE_MODE_ID,
+        "Phase Mode",
+        juce::StringArray({"Minimum Phase", "Linear Phase"}),
+        0
+    ));
+
+    // Tamanho do kernel de fase linear: mais longo resolve melhor os graves,
+    // com mais latência
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        LINEAR_PHASE_LENGTH_ID,
+        "Linear Phase Quality",
+        juce::StringArray({"Low (4096)", "Medium (8192)", "High (16384)", "Max (32768)"}),
+        1
+    ));
+
+    // Projeto dos coeficientes: bilinear (com compressão perto de Nyquist)
+    // ou casado com o protótipo analógico, sem custo extra por amostra
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        DESIGN_METHOD_ID,
+        "Filter Design",
+        juce::StringArray({"Bilinear", "Matched"}),
+        0
+    ));
+
     return {params.begin(), params.end()};
 }
 
 ParamEqAudioProcessor::~ParamEqAudioProcessor() //Destrutor da classe
 {
-    const juce::ScopedLock sl(analyzerLock);
-    spectrumAnalyzer = nullptr;
+    // Para as threads de fase linear e da curva antes que os parâmetros que
+    // elas leem sejam destruídos
+    linearPhase.release();
+    curveWorker.stop();
+    cancelPendingUpdate();
 }
 
 //================================= Inicializações midi, nome e presets ====================================
@@ -153,29 +309,249 @@ double ParamEqAudioProcessor::getTailLengthSeconds() const
 
 int ParamEqAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    // Alguns hosts não lidam bem com zero programas
+    const juce::ScopedLock lock(snapshotLock);
+    return juce::jmax(1, presetBank.getNumPresets());
 }
 
 int ParamEqAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
+// Carrega o preset do banco e troca para ele como um snapshot
 void ParamEqAudioProcessor::setCurrentProgram (int index)
 {
+    const juce::ScopedLock lock(snapshotLock);
+    std::vector<float> values(static_cast<size_t>(presetBank.getNumValues()));
+
+    if (! presetBank.readPreset(index, values.data()))
+        return;
+
+    currentProgram = index;
+    currentSnapshotSlot = -1;
+    switchToSnapshot(makeSnapshot(mapStateValues(presetBank.getParameterIDs(), values.data()).data()));
 }
 
 const juce::String ParamEqAudioProcessor::getProgramName (int index)
 {
-    return {};
+    const juce::ScopedLock lock(snapshotLock);
+    return presetBank.getPresetName(index);
 }
 
 void ParamEqAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    const juce::ScopedLock lock(snapshotLock);
+
+    if (! presetBank.isOpen())
+        return;
+
+    // O mapeamento é só de leitura: fecha, grava o nome e mapeia de novo
+    const auto bankFile = presetBank.getFile();
+    presetBank.close();
+    PresetBank::renamePreset(bankFile, index, newName);
+    presetBank.open(bankFile, knownStateLayouts);
 }
 
 //================================== buffer =========================================
+// Cria os sobreamostradores de todos os fatores para a precisão em uso, para
+// que a troca de fator na thread de áudio não precise alocar
+void ParamEqAudioProcessor::prepareOversamplers(int numChannels, int maximumBlockSize, bool useDouble)
+{
+    for (int index = 0; index < NUM_OVERSAMPLING_FACTORS; ++index)
+    {
+        floatOversamplers[index].reset();
+        doubleOversamplers[index].reset();
+
+        if (index == 0 || numChannels <= 0)
+            continue;
+
+        // Filtros FIR de fase linear com latência inteira, para que a
+        // latência informada ao host seja exata
+        if (useDouble)
+        {
+            doubleOversamplers[index] = std::make_unique<juce::dsp::Oversampling<double>>(
+                static_cast<size_t>(numChannels), static_cast<size_t>(index),
+                juce::dsp::Oversampling<double>::filterHalfBandFIREquiripple, true, true);
+            doubleOversamplers[index]->initProcessing(static_cast<size_t>(maximumBlockSize));
+        }
+        else
+        {
+            floatOversamplers[index] = std::make_unique<juce::dsp::Oversampling<float>>(
+                static_cast<size_t>(numChannels), static_cast<size_t>(index),
+                juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+            floatOversamplers[index]->initProcessing(static_cast<size_t>(maximumBlockSize));
+        }
+    }
+}
+
+int ParamEqAudioProcessor::getOversamplingLatency(int index) const noexcept
+{
+    if (isUsingDoublePrecision())
+        return doubleOversamplers[index] != nullptr ? juce::roundToInt(doubleOversamplers[index]->getLatencyInSamples()) : 0;
+
+    return floatOversamplers[index] != nullptr ? juce::roundToInt(floatOversamplers[index]->getLatencyInSamples()) : 0;
+}
+
+// Troca o fator de sobreamostragem; chamado na thread de áudio. Os filtros
+// são reprojetados na nova taxa e o estado começa do zero
+void ParamEqAudioProcessor::setOversamplingIndex(int newIndex) noexcept
+{
+    if (newIndex == oversamplingIndex)
+        return;
+
+    oversamplingIndex = newIndex;
+    processingSampleRate = spec.sampleRate * static_cast<double>(1 << newIndex);
+
+    if (floatOversamplers[newIndex] != nullptr)
+        floatOversamplers[newIndex]->reset();
+    if (doubleOversamplers[newIndex] != nullptr)
+        doubleOversamplers[newIndex]->reset();
+
+    floatCascade.reset();
+    doubleCascade.reset();
+    snapshotFadeRemaining = 0;
+
+    const int fadeLength = juce::roundToInt(processingSampleRate * bandFadeTimeSeconds);
+    floatCascade.setFadeLength(fadeLength);
+    doubleCascade.setFadeLength(fadeLength);
+
+    // Os coeficientes dependem da taxa de amostragem
+    // A nova lista de bandas ativas entra sem crossfade
+    resetSmoothers(spec.sampleRate);
+    scheduleNeedsJump = true;
+    for (auto& dirty : coefficientsDirty) dirty = true;
+
+    // O kernel de fase linear também segue a taxa de projeto
+    linearPhase.requestKernelUpdate();
+    updateLatency();
+}
+
+DesignMethod ParamEqAudioProcessor::getDesignMethodParameter() const noexcept
+{
+    return designMethodParameter->load(std::memory_order_relaxed) >= 0.5f ? MATCHED : BILINEAR;
+}
+
+// Troca o método de projeto; chamado na thread de áudio. Todas as bandas são
+// reprojetadas no próximo passe de coeficientes
+void ParamEqAudioProcessor::setDesignMethod(DesignMethod newMethod) noexcept
+{
+    if (newMethod == designMethod)
+        return;
+
+    designMethod = newMethod;
+    for (auto& dirty : coefficientsDirty) dirty = true;
+    linearPhase.requestKernelUpdate();
+}
+
+// Liga ou desliga o modo de fase linear; chamado na thread de áudio
+void ParamEqAudioProcessor::setLinearPhaseMode(bool enabled, int lengthIndex) noexcept
+{
+    // A thread de construção segue o pedido mesmo antes da troca
+    linearPhase.setActive(enabled);
+
+    // Na primeira ativação os kernels ainda não existem: a troca fica
+    // adiada e, até lá, a cascata continua com a latência dela. Os
+    // recursos são criados fora da thread de áudio
+    if (enabled && ! linearPhase.isReady())
+    {
+        if (! linearPhaseResourcesRequested)
+        {
+            linearPhaseResourcesRequested = true;
+            triggerAsyncUpdate();
+        }
+
+        enabled = false;
+    }
+    else if (! enabled)
+    {
+        linearPhaseResourcesRequested = false;
+    }
+
+    if (enabled == linearPhaseActive && lengthIndex == linearPhaseLengthIndex)
+        return;
+
+    // O caminho que volta a ser usado começa sem o histórico antigo; o
+    // anterior continua intacto para o crossfade
+    if (enabled != linearPhaseActive)
+    {
+        if (enabled)
+        {
+            linearPhase.reset();
+        }
+        else
+        {
+            floatCascade.reset();
+            doubleCascade.reset();
+
+            if (floatOversamplers[oversamplingIndex] != nullptr)
+                floatOversamplers[oversamplingIndex]->reset();
+            if (doubleOversamplers[oversamplingIndex] != nullptr)
+                doubleOversamplers[oversamplingIndex]->reset();
+        }
+
+        pathFadeLength = juce::jmax(1, juce::roundToInt(spec.sampleRate * pathFadeTimeSeconds));
+        pathFadeRemaining = pathFadeLength;
+        pathFadeFromLinear = linearPhaseActive;
+    }
+
+    if (lengthIndex != linearPhaseLengthIndex)
+        linearPhase.requestKernelUpdate();
+
+    linearPhaseActive = enabled;
+    linearPhaseLengthIndex = lengthIndex;
+    updateLatency();
+}
+
+// Parâmetros atuais para a thread que monta o kernel de fase linear
+LinearPhaseEngine::Design ParamEqAudioProcessor::makeLinearPhaseDesign() const
+{
+    LinearPhaseEngine::Design design;
+
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        const auto params = readBandParams(band);
+        auto& b = design.bands[(size_t) band];
+        b.type = params.type;
+        b.freq = params.freq;
+        b.q = params.q;
+        b.gainDb = params.gainDb;
+        b.channel = params.channel;
+    }
+
+    design.kernelLengthIndex = static_cast<int>(linearPhaseLengthParameter->load());
+    design.method = getDesignMethodParameter();
+    design.designOversampling = static_cast<double>(1 << juce::jlimit(0, NUM_OVERSAMPLING_FACTORS - 1,
+                                                                      static_cast<int>(oversamplingParameter->load())));
+    return design;
+}
+
+int ParamEqAudioProcessor::computeLatencySamples() const noexcept
+{
+    // Em fase linear a sobreamostragem só afeta o projeto do kernel
+    if (linearPhaseActive)
+        return linearPhase.getLatencySamples(linearPhaseLengthIndex);
+
+    return getOversamplingLatency(oversamplingIndex);
+}
+
+void ParamEqAudioProcessor::updateLatency() noexcept
+{
+    // setLatencySamples notifica o host, então é chamado na thread de mensagens
+    pendingLatencySamples = computeLatencySamples();
+    triggerAsyncUpdate();
+}
+
+void ParamEqAudioProcessor::handleAsyncUpdate()
+{
+    // A primeira ativação da fase linear cria os recursos do modo aqui,
+    // fora da thread de áudio
+    if (phaseModeParameter->load() >= 0.5f)
+        linearPhase.ensureResources();
+
+    setLatencySamples(pendingLatencySamples.load());
+}
+
 void ParamEqAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     // Configura o ProcessSpec com informações do host
@@ -183,17 +559,62 @@ void ParamEqAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBloc
     spec.maximumBlockSize = samplesPerBlock;  // Tamanho máximo do buffer
     spec.numChannels = getTotalNumOutputChannels();  // Número de canais
 
-    // Prepara o filtro com as especificações
-    for(auto& filter : filters) { // Prepara todos os filtros
-        filter.prepare(spec);
-    }
+    // Prepara apenas a cascata da precisão em uso; a outra fica sem canais
+    const int numChannels = static_cast<int>(spec.numChannels);
+    const bool useDouble = isUsingDoublePrecision();
+    floatCascade.prepare(useDouble ? 0 : numChannels);
+    doubleCascade.prepare(useDouble ? numChannels : 0);
+
+    // Cascata anterior e cópia da entrada para o crossfade das trocas de
+    // snapshot, no tamanho do maior bloco sobreamostrado
+    const int maxCascadeBlockSize = juce::jmax(1, samplesPerBlock) << (NUM_OVERSAMPLING_FACTORS - 1);
+    floatOutgoingCascade.prepare(useDouble ? 0 : numChannels);
+    doubleOutgoingCascade.prepare(useDouble ? numChannels : 0);
+    floatFadeScratch.setSize(useDouble ? 0 : numChannels, useDouble ? 0 : maxCascadeBlockSize);
+    doubleFadeScratch.setSize(useDouble ? numChannels : 0, useDouble ? maxCascadeBlockSize : 0);
+    snapshotFadeRemaining = 0;
+
+    // Os detectores rodam na taxa do host, sobre a entrada; as bandas são
+    // reconfiguradas no primeiro passe de coeficientes
+    dynamicsDetector.prepare(sampleRate);
+    dynamicBands = 0;
+    dynamicReductionDb.fill(0.0f);
+
+    // Buffers de trabalho: processBlock não aloca nada
+    analyzerScratch.setSize(NUM_ANALYZER_TAPS, juce::jmax(1, samplesPerBlock));
+    prepareOversamplers(numChannels, juce::jmax(1, samplesPerBlock), useDouble);
+    designMethod = getDesignMethodParameter();
+
+    // Aplica o fator atual. Vem antes da fase linear: a construção síncrona
+    // abaixo descarta o pedido de kernel que a troca de fator deixa pendente
+    oversamplingIndex = -1;
+    setOversamplingIndex(juce::jlimit(0, NUM_OVERSAMPLING_FACTORS - 1,
+                                      static_cast<int>(oversamplingParameter->load())));
+
+    // Com a fase linear já ligada, os kernels são montados na preparação
+    // para que o primeiro bloco saia correto mesmo em renderização offline;
+    // caso contrário nada é criado até o modo ser ligado
+    linearPhaseActive = phaseModeParameter->load() >= 0.5f;
+    linearPhaseLengthIndex = static_cast<int>(linearPhaseLengthParameter->load());
+    linearPhase.prepare({ sampleRate, static_cast<juce::uint32>(juce::jmax(1, samplesPerBlock)), spec.numChannels },
+                        linearPhaseActive);
+    linearPhase.setActive(linearPhaseActive);
+    linearPhaseResourcesRequested = false;
+
+    // Cópia da entrada para o crossfade entre cascata e fase linear
+    floatPathFadeScratch.setSize(useDouble ? 0 : numChannels, useDouble ? 0 : juce::jmax(1, samplesPerBlock));
+    doublePathFadeScratch.setSize(useDouble ? numChannels : 0, useDouble ? juce::jmax(1, samplesPerBlock) : 0);
+    pathFadeRemaining = 0;
+
+    // Já informa a latência correspondente
+    cancelPendingUpdate();
+    setLatencySamples(computeLatencySamples());
 
 }
 
 void ParamEqAudioProcessor::releaseResources()
 {
-    juce::ScopedLock sl(analyzerLock);
-    spectrumAnalyzer = nullptr; // **Seguro se a GUI for fechada**
+    linearPhase.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -203,12 +624,11 @@ bool ParamEqAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Aceita qualquer layout (mono, estéreo, surround, imersivo ou discreto)
+    // com até maxChannels canais; os canais são processados em paralelo
+    // nas lanes SIMD da cascata
+    const int numOutputChannels = layouts.getMainOutputChannelSet().size();
+    if (numOutputChannels < 1 || numOutputChannels > BiquadCascade<float>::maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -222,12 +642,111 @@ bool ParamEqAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 }
 #endif
 
-// Envia o buffer para o analisador de espectro
-void ParamEqAudioProcessor::pushBufferToAnalyzer(const juce::AudioBuffer<float>& buffer)
+// Lê os valores atuais de uma banda pela cópia do processador
+BandParams ParamEqAudioProcessor::readBandParams(int band) const noexcept
 {
-    const juce::ScopedLock sl(analyzerLock);
-    if (spectrumAnalyzer != nullptr && buffer.getNumSamples() > 0)
-        spectrumAnalyzer->pushBuffer(buffer);
+    const auto& bandValues = bandParameterValues[band];
+    std::array<float, NUM_BAND_PARAMETERS> values;
+
+    for (int p = 0; p < NUM_BAND_PARAMETERS; ++p)
+        values[(size_t) p] = bandValues[p].load(std::memory_order_relaxed);
+
+    return makeBandParams(values);
+}
+
+// Converte os valores crus dos parâmetros de uma banda
+BandParams ParamEqAudioProcessor::makeBandParams(const std::array<float, NUM_BAND_PARAMETERS>& values) noexcept
+{
+    BandParams params;
+    params.freq = values[BAND_FREQ];
+    params.gainDb = values[BAND_GAIN];
+    params.q = values[BAND_Q];
+    params.type = getMappedFilterType(static_cast<int>(values[BAND_TYPE]));
+    params.channel = static_cast<int>(values[BAND_CHANNEL]) - 1; // 0 = todos
+    params.dynamic = values[BAND_DYNAMIC] >= 0.5f;
+    params.thresholdDb = values[BAND_THRESHOLD];
+    params.ratio = juce::jmax(1.0f, values[BAND_RATIO]);
+    params.attackMs = values[BAND_ATTACK];
+    params.releaseMs = values[BAND_RELEASE];
+    return params;
+}
+
+// Copia os parâmetros de todas as bandas no início do bloco; o restante
+// do processamento lê apenas esta cópia
+void ParamEqAudioProcessor::takeParameterSnapshot() noexcept
+{
+    for (int band = 0; band < NUM_BANDS; ++band)
+        bandParams[band] = readBandParams(band);
+}
+
+// Soma os canais em mono no canal de trabalho da captura. O host pode
+// enviar blocos maiores que o anunciado em prepareToPlay; nesse caso só o
+// começo do bloco vai para o analisador
+void ParamEqAudioProcessor::captureAnalyzerTap(const juce::AudioBuffer<float>& buffer, AnalyzerTap tap) noexcept
+{
+    const int numChannels = buffer.getNumChannels();
+    const int count = juce::jmin(buffer.getNumSamples(), analyzerScratch.getNumSamples());
+
+    if (count <= 0 || numChannels <= 0)
+        return;
+
+    const float gainFactor = 1.0f / std::sqrt(static_cast<float>(numChannels));
+    float* mono = analyzerScratch.getWritePointer(tap);
+
+    juce::FloatVectorOperations::copyWithMultiply(mono, buffer.getReadPointer(0), gainFactor, count);
+    for (int ch = 1; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::addWithMultiply(mono, buffer.getReadPointer(ch), gainFactor, count);
+}
+
+// Versão para o caminho em double: a análise de espectro continua em float
+void ParamEqAudioProcessor::captureAnalyzerTap(const juce::AudioBuffer<double>& buffer, AnalyzerTap tap) noexcept
+{
+    const int numChannels = buffer.getNumChannels();
+    const int count = juce::jmin(buffer.getNumSamples(), analyzerScratch.getNumSamples());
+
+    if (count <= 0 || numChannels <= 0)
+        return;
+
+    const double gainFactor = 1.0 / std::sqrt(static_cast<double>(numChannels));
+    float* mono = analyzerScratch.getWritePointer(tap);
+    const double* first = buffer.getReadPointer(0);
+
+    for (int i = 0; i < count; ++i)
+        mono[i] = static_cast<float>(first[i] * gainFactor);
+
+    for (int ch = 1; ch < numChannels; ++ch)
+    {
+        const double* src = buffer.getReadPointer(ch);
+        for (int i = 0; i < count; ++i)
+            mono[i] += static_cast<float>(src[i] * gainFactor);
+    }
+}
+
+// Envia todas as capturas do bloco de uma vez
+void ParamEqAudioProcessor::pushAnalyzerTaps(int numSamples) noexcept
+{
+    const int count = juce::jmin(numSamples, analyzerScratch.getNumSamples());
+
+    // Nunca espera: se a fila estiver cheia, as amostras são descartadas
+    if (count > 0)
+    {
+        const int pushed = analyzerFifo.push(analyzerScratch.getArrayOfReadPointers(), count);
+        PARAMEQ_TELEMETRY(telemetry.recordAnalyzerPush(pushed, count));
+        juce::ignoreUnused(pushed);
+    }
+}
+
+// Curva total e de cada banda para a GUI; chamado pela thread da curva
+EqCurveWorker::Curve ParamEqAudioProcessor::computeEqCurveSnapshot(int numPoints)
+{
+    EqCurveWorker::Curve curve;
+    curve.total = getEqCurve(numPoints, static_cast<float>(getSampleRate()));
+
+    // As curvas das bandas já foram calculadas (ou reaproveitadas) pelo avaliador
+    for (int band = 0; band < NUM_BANDS; ++band)
+        curve.bands.push_back(responseEvaluator.getBandCurve(band));
+
+    return curve;
 }
 
 FilterType getMappedFilterType(int choiceIndex)
@@ -245,135 +764,624 @@ FilterType getMappedFilterType(int choiceIndex)
 
 std::vector<float> ParamEqAudioProcessor::getEqCurve(int numPoints, float sampleRate)
 {
-    updateCachedCoefficients(); // atualiza o cache se necessário
+    if (sampleRate <= 0.0f)
+        sampleRate = 44100.0f;
 
-    std::vector<float> curve(numPoints, 0.0f);
+    // Com sobreamostragem, os coeficientes são avaliados na taxa em que
+    // foram projetados
+    const double designRate = publishedSampleRate.load(std::memory_order_relaxed) > 0.0
+                                ? publishedSampleRate.load(std::memory_order_relaxed)
+                                : static_cast<double>(sampleRate);
 
-    for (int i = 0; i < numPoints; ++i)
-    {
-        float freq = juce::mapToLog10(float(i) / (numPoints - 1), 20.0f, 20000.0f);
-        float totalMagnitude = 1.0f;
+    // As tabelas só são refeitas quando a largura ou a taxa mudam
+    responseEvaluator.prepare(numPoints, designRate);
 
-        for (int band = 0; band < NUM_BANDS; ++band)
+    // Usa os coeficientes publicados pela thread de áudio; bandas ainda não
+    // processadas por ela são projetadas aqui mesmo. Só as bandas cujos
+    // coeficientes mudaram têm a curva recalculada
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        if (coefficientsDirty[band])
         {
-            auto* coeffs = cachedCoefficients[band].get();
-            if (coeffs != nullptr)
-            {
-                totalMagnitude *= coeffs->getMagnitudeForFrequency(freq, sampleRate);
-            }
+            const auto params = readBandParams(band);
+            responseEvaluator.setBand(band, CoefficientDesigner::design(params.type, designRate, params.freq, params.q, params.gainDb,
+                                                                        getDesignMethodParameter()));
+        }
+        else
+        {
+            responseEvaluator.setBand(band, publishedCoefficients.read(band));
         }
-
-        curve[i] = juce::Decibels::gainToDecibels(totalMagnitude);
     }
 
-    return curve;
+    return responseEvaluator.getTotalCurve();
+}
+
+
+void ParamEqAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer, midiMessages, floatCascade, floatOversamplers);
 }
 
+// Caminho nativo em double: hosts com motor de mixagem de 64 bits não
+// precisam converter o buffer para float
+void ParamEqAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer, midiMessages, doubleCascade, doubleOversamplers);
+}
 
-void ParamEqAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) 
+template <typename SampleType>
+void ParamEqAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages,
+                                           BiquadCascade<SampleType>& cascade, OversamplerSet<SampleType>& oversamplers)
 {
     juce::ScopedNoDenormals noDenormals;
+    PARAMEQ_TELEMETRY(const auto blockStartTicks = juce::Time::getHighResolutionTicks());
     midiMessages.clear();
 
     // 1. Configuração inicial
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-    
-    // 2. Processamento principal
-    juce::dsp::AudioBlock<float> audioBlock(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(audioBlock);
 
-    // Atualiza os coeficientes se necessário
+    // Um estado restaurado entra de uma vez, sem rampa nem crossfade
+    if (stateRestorePending.exchange(false))
+    {
+        resetSmoothers(spec.sampleRate);
+        scheduleNeedsJump = true;
+    }
+
+    // Cópia dos parâmetros para este bloco
+    takeParameterSnapshot();
+    setOversamplingIndex(juce::jlimit(0, NUM_OVERSAMPLING_FACTORS - 1,
+                                      static_cast<int>(oversamplingParameter->load(std::memory_order_relaxed))));
+    auto* oversampler = oversamplers[oversamplingIndex].get();
+    setLinearPhaseMode(phaseModeParameter->load(std::memory_order_relaxed) >= 0.5f,
+                       static_cast<int>(linearPhaseLengthParameter->load(std::memory_order_relaxed)));
+    setDesignMethod(getDesignMethodParameter());
+
+    // Troca de snapshot ou preset: os coeficientes já vêm prontos
+    if (const auto* snapshot = pendingSnapshot.exchange(nullptr))
+        applySnapshot(*snapshot, cascade);
+
+    // A entrada é capturada antes do equalizador; a decisão vale para o
+    // bloco inteiro, para que as duas capturas fiquem alinhadas
+    const bool analyzing = analyzerActive.load(std::memory_order_relaxed);
+
+    if (analyzing)
+        captureAnalyzerTap(buffer, INPUT_TAP);
+
+    // 2. Processamento principal
+    // Atualiza os coeficientes e a lista de bandas ativas se necessário;
+    // a cascata processa apenas as seções dessa lista
     updateCachedCoefficients();
 
-    for (int band = 0; band < NUM_BANDS; ++band)
-    {
-        auto gainDb = parameters.getRawParameterValue("GAIN" + juce::String(band + 1))->load();
-        auto typeValue = parameters.getRawParameterValue("TYPE" + juce::String(band + 1))->load();
-        FilterType currentType = getMappedFilterType(static_cast<int>(typeValue));
+    // Troca entre cascata e fase linear: a entrada é copiada para que o
+    // caminho anterior a processe depois do atual
+    auto& pathScratch = getPathFadeScratch<SampleType>();
+    const int numPathFadeChannels = juce::jmin(buffer.getNumChannels(), pathScratch.getNumChannels());
+    const int numPathFadeSamples = juce::jmin(numSamples, pathFadeRemaining, pathScratch.getNumSamples());
 
-        // Pula filtros inativos (exceto HP/LP, pois estes não possuem ganho)
-        if (std::abs(gainDb) < 0.1f && currentType != LOW_PASS && currentType != HIGH_PASS)
-            continue;
+    for (int ch = 0; ch < numPathFadeChannels; ++ch)
+        juce::FloatVectorOperations::copy(pathScratch.getWritePointer(ch), buffer.getReadPointer(ch), numPathFadeSamples);
+
+    // A telemetria usa a mesma decisão para contar as bandas processadas
+    const bool useLinearPhase = linearPhaseActive && linearPhase.isReady();
 
-        // Atualiza o filtro com o cache
-        auto* coeffs = cachedCoefficients[band].get();
-        if (coeffs != nullptr)
-            *filters[band].state = *coeffs;
+    if (useLinearPhase)
+    {
+        // O áudio passa só pelo kernel; as rampas continuam avançando para
+        // que a curva exibida chegue aos valores finais
+        if (rampingBands != 0)
+            advanceSmoothing(numSamples);
 
-        filters[band].process(context);
+        samplesUntilCoefficientUpdate = 0;
+        snapshotFadeRemaining = 0;
+        linearPhase.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
     }
-    // Análise de espectro
-    if (spectrumAnalyzer != nullptr) 
+    else if (rampingBands == 0 && dynamicBands == 0)
     {
-        juce::AudioBuffer<float> monoBuffer(1, numSamples);
-        const float gainFactor = 1.0f / std::sqrt(numChannels);
-        
-        for (int i = 0; i < numSamples; ++i) 
+        // Caminho rápido: nenhum parâmetro em movimento, o bloco inteiro
+        // é processado com os mesmos coeficientes
+        samplesUntilCoefficientUpdate = 0;
+        processRange(buffer, cascade, oversampler, 0, numSamples);
+    }
+    else
+    {
+        for (int start = 0; start < numSamples;)
         {
-            float sum = 0.0f;
-            for (int ch = 0; ch < numChannels; ++ch) 
+            if (rampingBands == 0 && dynamicBands == 0)
+            {
+                samplesUntilCoefficientUpdate = 0;
+                processRange(buffer, cascade, oversampler, start, numSamples - start);
+                break;
+            }
+
+            if (samplesUntilCoefficientUpdate <= 0)
             {
-                sum += buffer.getSample(ch, i);
+                // Primeiro as reduções dos detectores, que as rampas também usam
+                if (dynamicBands != 0)
+                    updateDynamicGains();
+                if (rampingBands != 0)
+                    advanceSmoothing(coefficientUpdateInterval);
+
+                samplesUntilCoefficientUpdate = coefficientUpdateInterval;
             }
-            monoBuffer.setSample(0, i, gainFactor * sum);
+
+            const int subBlockSize = juce::jmin(samplesUntilCoefficientUpdate, numSamples - start);
+
+            // O trecho ainda não passou pelo equalizador: é o sidechain
+            if (dynamicBands != 0)
+                runDetectors(buffer, start, subBlockSize);
+
+            processRange(buffer, cascade, oversampler, start, subBlockSize);
+
+            samplesUntilCoefficientUpdate -= subBlockSize;
+            start += subBlockSize;
+        }
+    }
+
+    if (numPathFadeSamples > 0)
+    {
+        // O caminho anterior processa a cópia com o estado que já tinha;
+        // rampa linear da saída dele para a do caminho atual
+        if (pathFadeFromLinear)
+            linearPhase.process(pathScratch.getArrayOfWritePointers(), numPathFadeChannels, numPathFadeSamples);
+        else
+            processRange(pathScratch, cascade, oversampler, 0, numPathFadeSamples);
+
+        const auto step = SampleType(1) / static_cast<SampleType>(pathFadeLength);
+        const auto firstGain = static_cast<SampleType>(pathFadeLength - pathFadeRemaining + 1) * step;
+
+        for (int ch = 0; ch < numPathFadeChannels; ++ch)
+        {
+            SampleType* out = buffer.getWritePointer(ch);
+            const SampleType* previous = pathScratch.getReadPointer(ch);
+
+            for (int i = 0; i < numPathFadeSamples; ++i)
+                out[i] = previous[i] + (firstGain + step * static_cast<SampleType>(i)) * (out[i] - previous[i]);
         }
-        pushBufferToAnalyzer(monoBuffer);
+
+        pathFadeRemaining -= numPathFadeSamples;
     }
+    else
+    {
+        pathFadeRemaining = 0;
+    }
+
+    // Análise de espectro
+    if (analyzing)
+    {
+        captureAnalyzerTap(buffer, OUTPUT_TAP);
+        pushAnalyzerTaps(numSamples);
+    }
+
+   #if PARAMEQ_ENABLE_TELEMETRY
+    // Em fase linear a cascata não roda: todas as bandas contam como puladas
+    const int processedBands = useLinearPhase ? 0 : juce::countNumberOfBits(activeBandMask);
+    telemetry.recordBlock(juce::Time::getHighResolutionTicks() - blockStartTicks, numSamples, getSampleRate(),
+                          processedBands, NUM_BANDS - processedBands);
+   #endif
 }
 
-void ParamEqAudioProcessor::parameterValueChanged(int index, float newValue)
+template <typename SampleType>
+void ParamEqAudioProcessor::processRange(juce::AudioBuffer<SampleType>& buffer, BiquadCascade<SampleType>& cascade,
+                                         juce::dsp::Oversampling<SampleType>* oversampler, int startSample, int numSamples) noexcept
 {
-    auto* rawParam = getParameters()[index];
-    auto* param = dynamic_cast<juce::AudioProcessorParameterWithID*>(rawParam);
-    if (!param) return;
+    const int numChannels = buffer.getNumChannels();
 
-    const juce::String id = param->getParameterID();
-    for (int band = 0; band < NUM_BANDS; ++band)
+    if (oversampler == nullptr)
+    {
+        processCascade(cascade, buffer.getArrayOfWritePointers(), numChannels, startSample, numSamples);
+        return;
+    }
+
+    // O sobreamostrador foi preparado para o tamanho máximo de bloco; blocos
+    // maiores são divididos
+    const int maxChunkSize = static_cast<int>(spec.maximumBlockSize);
+    const int factor = static_cast<int>(oversampler->getOversamplingFactor());
+    SampleType* upChannels[BiquadCascade<SampleType>::maxChannels] = {};
+
+    for (int start = startSample; start < startSample + numSamples; start += maxChunkSize)
+    {
+        const int chunkSize = juce::jmin(maxChunkSize, startSample + numSamples - start);
+        auto block = juce::dsp::AudioBlock<SampleType>(buffer).getSubBlock(static_cast<size_t>(start), static_cast<size_t>(chunkSize));
+
+        auto upBlock = oversampler->processSamplesUp(block);
+        const int numUpChannels = juce::jmin(numChannels, BiquadCascade<SampleType>::maxChannels);
+        for (int ch = 0; ch < numUpChannels; ++ch)
+            upChannels[ch] = upBlock.getChannelPointer(static_cast<size_t>(ch));
+
+        processCascade(cascade, upChannels, numUpChannels, 0, chunkSize * factor);
+        oversampler->processSamplesDown(block);
+    }
+}
+
+template <typename SampleType>
+void ParamEqAudioProcessor::processCascade(BiquadCascade<SampleType>& cascade, SampleType* const* channels,
+                                           int numChannels, int startSample, int numSamples) noexcept
+{
+    auto& outgoing = getOutgoingCascade<SampleType>();
+    auto& scratch = getFadeScratch<SampleType>();
+    const int numFadeChannels = juce::jmin(numChannels, scratch.getNumChannels());
+
+    while (snapshotFadeRemaining > 0 && numSamples > 0)
     {
-        if (id.contains(juce::String(band + 1)))
+        // A cascata anterior processa uma cópia da entrada; o trecho é
+        // limitado ao fim do fade e ao tamanho da cópia
+        const int segmentSize = juce::jmin(numSamples, snapshotFadeRemaining, scratch.getNumSamples());
+
+        if (segmentSize <= 0)
         {
-            coefficientsDirty[band] = true;
-            eqCurveNeedsUpdate = true;
+            snapshotFadeRemaining = 0;
             break;
         }
+
+        for (int ch = 0; ch < numFadeChannels; ++ch)
+            juce::FloatVectorOperations::copy(scratch.getWritePointer(ch), channels[ch] + startSample, segmentSize);
+
+        outgoing.process(scratch.getArrayOfWritePointers(), numFadeChannels, 0, segmentSize);
+        cascade.process(channels, numChannels, startSample, segmentSize);
+
+        // Rampa linear da saída anterior para a nova
+        const auto step = SampleType(1) / static_cast<SampleType>(snapshotFadeLength);
+        const auto firstGain = static_cast<SampleType>(snapshotFadeLength - snapshotFadeRemaining + 1) * step;
+
+        for (int ch = 0; ch < numFadeChannels; ++ch)
+        {
+            SampleType* out = channels[ch] + startSample;
+            const SampleType* previous = scratch.getReadPointer(ch);
+
+            for (int i = 0; i < segmentSize; ++i)
+                out[i] = previous[i] + (firstGain + step * static_cast<SampleType>(i)) * (out[i] - previous[i]);
+        }
+
+        snapshotFadeRemaining -= segmentSize;
+        startSample += segmentSize;
+        numSamples -= segmentSize;
+    }
+
+    if (numSamples > 0)
+        cascade.process(channels, numChannels, startSample, numSamples);
+}
+
+// Aplica um snapshot na thread de áudio: a cascata atual vira a anterior do
+// crossfade e recebe os coeficientes prontos, sem rampa
+template <typename SampleType>
+void ParamEqAudioProcessor::applySnapshot(const EqSnapshot& snapshot, BiquadCascade<SampleType>& cascade) noexcept
+{
+    // Coeficientes projetados para outra taxa ou outro método (ou em fase
+    // linear, onde a cascata não roda): os parâmetros já têm os valores do
+    // snapshot e as bandas são reprojetadas pelo caminho normal, sem rampa
+    if (linearPhaseActive || snapshot.designRate != processingSampleRate || snapshot.method != designMethod)
+    {
+        resetSmoothers(spec.sampleRate);
+        scheduleNeedsJump = true;
+        for (auto& dirty : coefficientsDirty) dirty = true;
+        return;
+    }
+
+    // Uma troca no meio de outro fade recomeça a partir da cascata atual
+    getOutgoingCascade<SampleType>() = cascade;
+
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        const auto& params = snapshot.bands[(size_t) band];
+        auto& smoother = bandSmoothers[band];
+
+        bandParams[band] = params;
+        smoother.type = params.type;
+        smoother.channel = params.channel;
+        smoother.freq.setCurrentAndTargetValue(params.freq);
+        smoother.q.setCurrentAndTargetValue(params.q);
+        smoother.gainDb.setCurrentAndTargetValue(params.gainDb);
+
+        setBandCoefficients(band, snapshot.coefficients[(size_t) band], params.channel);
+        designedGainDb[band] = params.gainDb;
+        configureDynamics(band);
+    }
+
+    rampingBands = 0;
+    samplesUntilCoefficientUpdate = 0;
+
+    // O crossfade entre as cascatas já cobre bandas que entram ou saem
+    updateActiveSchedule(false);
+    scheduleNeedsJump = false;
+
+    snapshotFadeLength = juce::jmax(1, juce::roundToInt(processingSampleRate * snapshotFadeTimeSeconds));
+    snapshotFadeRemaining = snapshotFadeLength;
+    curveWorker.requestUpdate();
+}
+
+void ParamEqAudioProcessor::parameterValueChanged(int index, float newValue)
+{
+    if (! juce::isPositiveAndBelow(index, static_cast<int>(parameterIndexToBand.size())))
+        return;
+
+    const int band = parameterIndexToBand[static_cast<size_t>(index)];
+    if (band < 0)
+        return;
+
+    // Os listeners são chamados na ordem inversa do registro, então este
+    // roda antes de o adaptador da APVTS gravar o valor cru. A cópia do
+    // processador é gravada antes da flag, para que um bloco que consuma a
+    // flag nesse intervalo já leia o valor final do gesto
+    const int parameter = parameterIndexToBandParameter[static_cast<size_t>(index)];
+    bandParameterValues[band][parameter].store(stateParameters[static_cast<size_t>(index)]->convertFrom0to1(newValue),
+                                               std::memory_order_relaxed);
+
+    if (index == restoringParameterIndex.load(std::memory_order_relaxed))
+        return;
+
+    coefficientsDirty[band] = true;
+
+    // Os parâmetros de dinâmica não mudam o kernel; a curva acompanha os
+    // coeficientes que a thread de áudio publica depois do recálculo
+    if (parameterAffectsShape[static_cast<size_t>(index)])
+    {
+        curveWorker.requestUpdate();
+        linearPhase.requestKernelUpdate();
     }
 }
 
 void ParamEqAudioProcessor::updateCachedCoefficients()
 {
+    bool anyBandChanged = false;
+
     for (int band = 0; band < NUM_BANDS; ++band)
     {
-        if (!coefficientsDirty[band])
+        // Limpa a flag antes de reler a banda: mudanças que chegarem depois
+        // disso marcam a banda novamente para o próximo bloco
+        if (! coefficientsDirty[band].exchange(false))
             continue;
 
-        auto freq = parameters.getRawParameterValue("FREQ" + juce::String(band + 1))->load();
-        auto q = parameters.getRawParameterValue("Q" + juce::String(band + 1))->load();
-        auto gainDb = parameters.getRawParameterValue("GAIN" + juce::String(band + 1))->load();
-        FilterType currentType = getMappedFilterType(
-            parameters.getRawParameterValue("TYPE" + juce::String(band + 1))->load());
+        bandParams[band] = readBandParams(band);
+        const auto& params = bandParams[band];
+        auto& smoother = bandSmoothers[band];
+        const auto bandBit = 1u << band;
 
-        switch (currentType)
+        if (params.type != smoother.type || params.channel != smoother.channel)
         {
-            case PEAK:
-                cachedCoefficients[band] = juce::dsp::IIR::Coefficients<float>::makePeakFilter(spec.sampleRate, freq, q, juce::Decibels::decibelsToGain(gainDb));
-                break;
-            case LOW_SHELF:
-                cachedCoefficients[band] = juce::dsp::IIR::Coefficients<float>::makeLowShelf(spec.sampleRate, freq, q, juce::Decibels::decibelsToGain(gainDb));
-                break;
-            case HIGH_SHELF:
-                cachedCoefficients[band] = juce::dsp::IIR::Coefficients<float>::makeHighShelf(spec.sampleRate, freq, q, juce::Decibels::decibelsToGain(gainDb));
-                break;
-            case LOW_PASS:
-                cachedCoefficients[band] = juce::dsp::IIR::Coefficients<float>::makeLowPass(spec.sampleRate, freq, q);
-                break;
-            case HIGH_PASS:
-                cachedCoefficients[band] = juce::dsp::IIR::Coefficients<float>::makeHighPass(spec.sampleRate, freq, q);
-                break;
+            // Não há rampa entre tipos de filtro nem entre canais diferentes:
+            // salta direto
+            smoother.type = params.type;
+            smoother.channel = params.channel;
+            smoother.freq.setCurrentAndTargetValue(params.freq);
+            smoother.q.setCurrentAndTargetValue(params.q);
+            smoother.gainDb.setCurrentAndTargetValue(params.gainDb);
+        }
+        else
+        {
+            smoother.freq.setTargetValue(params.freq);
+            smoother.q.setTargetValue(params.q);
+            smoother.gainDb.setTargetValue(params.gainDb);
+        }
+
+        configureDynamics(band);
+
+        if (smoother.isSmoothing())
+        {
+            // Os coeficientes serão recalculados na grade de sub-blocos
+            rampingBands |= bandBit;
+        }
+        else
+        {
+            rampingBands &= ~bandBit;
+            designBand(band, params.type, params.freq, params.q, getDynamicGainDb(band, params.gainDb), params.channel);
+        }
+
+        anyBandChanged = true;
+    }
+
+    // A curva da GUI passa a refletir os coeficientes recém publicados
+    if (anyBandChanged)
+    {
+        updateActiveSchedule(! scheduleNeedsJump);
+        scheduleNeedsJump = false;
+        curveWorker.requestUpdate();
+    }
+}
+
+// Refaz a lista de bandas ativas; só é chamado quando algum parâmetro muda
+// ou quando uma rampa de ganho termina
+void ParamEqAudioProcessor::updateActiveSchedule(bool crossfade) noexcept
+{
+    juce::uint32 activeBands = 0;
+
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        const auto& params = bandParams[band];
+        const auto& smoother = bandSmoothers[band];
+
+        // Pula filtros inativos (exceto HP/LP, pois estes não possuem ganho);
+        // bandas com ganho ainda em rampa continuam ativas até chegar ao alvo
+        if (std::abs(params.gainDb) < 0.1f && ! smoother.gainDb.isSmoothing() && (dynamicBands & (1u << band)) == 0
+            && params.type != LOW_PASS && params.type != HIGH_PASS)
+            continue;
+
+        // Bandas atribuídas a um canal que não existe no layout atual
+        if (smoother.channel >= static_cast<int>(spec.numChannels))
+            continue;
+
+        activeBands |= (1u << band);
+    }
+
+    // Bandas que entram ou saem da lista passam por um crossfade curto
+    activeBandMask = activeBands;
+    floatCascade.setActiveSections(activeBands, crossfade);
+    doubleCascade.setActiveSections(activeBands, crossfade);
+}
+
+// Projeta os coeficientes de uma banda e os entrega à cascata e à GUI
+void ParamEqAudioProcessor::designBand(int band, FilterType type, float freq, float q, float gainDb, int channel) noexcept
+{
+    setBandCoefficients(band, CoefficientDesigner::design(type, processingSampleRate, freq, q, gainDb, designMethod), channel);
+    designedGainDb[band] = gainDb;
+
+    PARAMEQ_TELEMETRY(telemetry.recordCoefficientUpdate(band));
+}
+
+void ParamEqAudioProcessor::setBandCoefficients(int band, const BiquadCoefficients& coeffs, int channel) noexcept
+{
+    floatCascade.setCoefficients(band, coeffs, channel);
+    doubleCascade.setCoefficients(band, coeffs, channel);
+    publishedCoefficients.publish(band, coeffs);
+    publishedSampleRate.store(processingSampleRate, std::memory_order_relaxed);
+}
+
+// Avança as rampas das bandas em movimento e recalcula seus coeficientes
+void ParamEqAudioProcessor::advanceSmoothing(int numSamples) noexcept
+{
+    bool rampFinished = false;
+
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        const auto bandBit = 1u << band;
+        if ((rampingBands & bandBit) == 0)
+            continue;
+
+        auto& smoother = bandSmoothers[band];
+        const auto freq = smoother.freq.skip(numSamples);
+        const auto q = smoother.q.skip(numSamples);
+        const auto gainDb = smoother.gainDb.skip(numSamples);
+
+        designBand(band, smoother.type, freq, q, getDynamicGainDb(band, gainDb), smoother.channel);
+
+        if (! smoother.isSmoothing())
+        {
+            rampingBands &= ~bandBit;
+            rampFinished = true;
+        }
+    }
+
+    // Uma banda cujo ganho chegou a zero pode sair da lista de ativas
+    if (rampFinished)
+        updateActiveSchedule(true);
+
+    curveWorker.requestUpdate();
+}
+
+// Liga ou desliga a dinâmica de uma banda e ajusta o detector dela; só
+// peak e shelves têm ganho para reduzir
+void ParamEqAudioProcessor::configureDynamics(int band) noexcept
+{
+    const auto& params = bandParams[band];
+    const auto bandBit = 1u << band;
+    const bool dynamic = params.dynamic && (params.type == PEAK || params.type == LOW_SHELF || params.type == HIGH_SHELF);
+
+    if (dynamic)
+    {
+        dynamicsDetector.setBand(band, params.freq, params.q, params.attackMs, params.releaseMs);
+        dynamicBands |= bandBit;
+    }
+    else
+    {
+        dynamicBands &= ~bandBit;
+        dynamicReductionDb[band] = 0.0f;
+    }
+
+    dynamicsDetector.setActiveBands(dynamicBands);
+}
+
+float ParamEqAudioProcessor::getDynamicGainDb(int band, float gainDb) const noexcept
+{
+    return (dynamicBands & (1u << band)) != 0 ? gainDb - dynamicReductionDb[band] : gainDb;
+}
+
+// Soma o trecho em mono e avança os detectores de todas as bandas juntos
+template <typename SampleType>
+void ParamEqAudioProcessor::runDetectors(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) noexcept
+{
+    const int numChannels = buffer.getNumChannels();
+    numSamples = juce::jmin(numSamples, coefficientUpdateInterval);
+
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    float sidechain[coefficientUpdateInterval] = {};
+    const auto gainFactor = static_cast<SampleType>(1) / static_cast<SampleType>(numChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const SampleType* src = buffer.getReadPointer(ch, startSample);
+        for (int i = 0; i < numSamples; ++i)
+            sidechain[i] += static_cast<float>(src[i] * gainFactor);
+    }
+
+    dynamicsDetector.process(sidechain, numSamples);
+}
+
+// Lê os detectores na grade de coeficientes e aplica a redução de ganho.
+// Bandas paradas usam o reprojeto só de ganho (no projeto casado, o
+// completo); bandas em rampa são projetadas por advanceSmoothing, que usa a
+// mesma redução
+void ParamEqAudioProcessor::updateDynamicGains() noexcept
+{
+    bool anyBandUpdated = false;
+
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        const auto bandBit = 1u << band;
+        if ((dynamicBands & bandBit) == 0)
+            continue;
+
+        const auto& params = bandParams[band];
+        const float overDb = dynamicsDetector.getLevelDb(band) - params.thresholdDb;
+        dynamicReductionDb[band] = overDb > 0.0f ? juce::jmin(maxDynamicReductionDb, overDb * (1.0f - 1.0f / params.ratio))
+                                                 : 0.0f;
+
+        if ((rampingBands & bandBit) != 0)
+            continue;
+
+        const auto& smoother = bandSmoothers[band];
+        const float gainDb = smoother.gainDb.getCurrentValue() - dynamicReductionDb[band];
+
+        // Mudanças menores que isso não são audíveis
+        if (std::abs(gainDb - designedGainDb[band]) < 0.01f)
+            continue;
+
+        const float freq = smoother.freq.getCurrentValue();
+        const float q = smoother.q.getCurrentValue();
+
+        if (GainOnlyDesigner::supports(smoother.type, designMethod))
+        {
+            auto& designer = gainDesigners[band];
+            if (! designer.isPreparedFor(smoother.type, processingSampleRate, freq, q))
+                designer.prepare(smoother.type, processingSampleRate, freq, q);
+
+            setBandCoefficients(band, designer.design(gainDb), smoother.channel);
+            designedGainDb[band] = gainDb;
+            PARAMEQ_TELEMETRY(telemetry.recordCoefficientUpdate(band));
+        }
+        else
+        {
+            designBand(band, smoother.type, freq, q, gainDb, smoother.channel);
         }
 
-        coefficientsDirty[band] = false;
+        anyBandUpdated = true;
+    }
+
+    if (anyBandUpdated)
+        curveWorker.requestUpdate();
+}
+
+// Reinicia as rampas na taxa de amostragem dada, saltando para os valores atuais
+void ParamEqAudioProcessor::resetSmoothers(double sampleRate)
+{
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        const auto params = readBandParams(band);
+        auto& smoother = bandSmoothers[band];
+
+        smoother.freq.reset(sampleRate, smoothingTimeSeconds);
+        smoother.q.reset(sampleRate, smoothingTimeSeconds);
+        smoother.gainDb.reset(sampleRate, smoothingTimeSeconds);
+
+        smoother.type = params.type;
+        smoother.channel = params.channel;
+        smoother.freq.setCurrentAndTargetValue(params.freq);
+        smoother.q.setCurrentAndTargetValue(params.q);
+        smoother.gainDb.setCurrentAndTargetValue(params.gainDb);
     }
+
+    rampingBands = 0;
+    samplesUntilCoefficientUpdate = 0;
 }
 
 //==============================================================================
@@ -390,15 +1398,307 @@ juce::AudioProcessorEditor* ParamEqAudioProcessor::createEditor()
 //================================ State do plugin =================================
 void ParamEqAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // Lê os valores direto dos handles, sem passar pela ValueTree
+    const auto values = getParameterValues();
+    BinaryStateFormat::write(destData, stateParameterIDs, values.data());
+}
+
+void ParamEqAudioProcessor::getXmlStateInformation(juce::MemoryBlock& destData)
+{
+    if (auto xml = parameters.copyState().createXml())
+        copyXmlToBinary(*xml, destData);
 }
 
 void ParamEqAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    restoreState(data, sizeInBytes);
+}
+
+bool ParamEqAudioProcessor::restoreState(const void* data, int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes <= 0)
+        return false;
+
+    // Estados antigos (XML) continuam sendo aceitos
+    if (BinaryStateFormat::isBinaryState(data, sizeInBytes))
+        return restoreBinaryState(data, sizeInBytes);
+
+    return restoreXmlState(data, sizeInBytes);
+}
+
+bool ParamEqAudioProcessor::restoreBinaryState(const void* data, int sizeInBytes)
+{
+    juce::StringArray ids;
+    std::vector<float> values;
+
+    if (! BinaryStateFormat::read(data, sizeInBytes, knownStateLayouts, ids, values))
+        return false;
+
+    applyStateValues(mapStateValues(ids, values.data()).data());
+    return true;
+}
+
+// IDs desconhecidos são ignorados e parâmetros ausentes ficam no valor
+// padrão, como em uma instância nova
+std::vector<float> ParamEqAudioProcessor::mapStateValues(const juce::StringArray& parameterIDs, const float* values) const
+{
+    if (parameterIDs == stateParameterIDs)
+        return std::vector<float>(values, values + parameterIDs.size());
+
+    auto mapped = stateDefaultValues;
+
+    for (int i = 0; i < parameterIDs.size(); ++i)
+        if (auto* parameter = parameters.getParameter(parameterIDs[i]))
+            mapped[static_cast<size_t>(parameter->getParameterIndex())] = values[i];
+
+    return mapped;
+}
+
+bool ParamEqAudioProcessor::restoreXmlState(const void* data, int sizeInBytes)
+{
+    // Aceita tanto o formato de copyXmlToBinary quanto XML em texto puro
+    auto xml = getXmlFromBinary(data, sizeInBytes);
+
+    if (xml == nullptr)
+        xml = juce::parseXML(juce::String::fromUTF8(static_cast<const char*>(data), sizeInBytes));
+
+    if (xml == nullptr || ! xml->hasTagName(parameters.state.getType()))
+        return false;
+
+    const auto tree = juce::ValueTree::fromXml(*xml);
+
+    // Parâmetros ausentes no XML mantêm o valor atual
+    std::vector<float> values(stateValueHandles.size());
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = stateValueHandles[i]->load(std::memory_order_relaxed);
+
+        const auto child = tree.getChildWithProperty("id", stateParameters[i]->getParameterID());
+        if (child.isValid() && child.hasProperty("value"))
+        {
+            const auto value = static_cast<float>(static_cast<double>(child.getProperty("value")));
+            if (std::isfinite(value))
+                values[i] = value;
+        }
+    }
+
+    applyStateValues(values.data());
+    return true;
+}
+
+// Aplica todos os valores em lote: o host é notificado dos que mudaram, mas
+// coeficientes, kernel de fase linear e curva da GUI são recalculados uma
+// única vez
+void ParamEqAudioProcessor::applyStateValues(const float* values)
+{
+    {
+        // Um snapshot ainda não aplicado traria coeficientes de outro estado;
+        // se a thread de áudio não o pegou, ele é descartado
+        const juce::ScopedLock lock(snapshotLock);
+        if (pendingSnapshot.exchange(nullptr) != nullptr)
+            pendingSnapshotOwner = nullptr;
+    }
+
+    setParameterValues(values);
+
+    for (auto& dirty : coefficientsDirty) dirty = true;
+    linearPhase.requestKernelUpdate();
+    curveWorker.requestUpdate();
+    stateRestorePending = true;
+}
+
+std::vector<float> ParamEqAudioProcessor::getParameterValues() const
+{
+    std::vector<float> values(stateValueHandles.size());
+
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = stateValueHandles[i]->load(std::memory_order_relaxed);
+
+    return values;
+}
+
+// O host é notificado dos parâmetros que mudaram; o listener das bandas
+// ignora só a notificação do parâmetro sendo gravado, e quem chama decide o
+// que recalcular. Automação do host em outros parâmetros durante o lote
+// continua marcando as bandas
+void ParamEqAudioProcessor::setParameterValues(const float* values)
+{
+    for (size_t i = 0; i < stateParameters.size(); ++i)
+    {
+        auto* parameter = stateParameters[i];
+        const float normalised = parameter->convertTo0to1(values[i]);
+
+        if (normalised != parameter->getValue())
+        {
+            restoringParameterIndex = static_cast<int>(i);
+            parameter->setValueNotifyingHost(normalised);
+        }
+    }
+
+    restoringParameterIndex = -1;
+}
+
+//================================ Snapshots e presets =================================
+// Taxa da cascata com o fator de sobreamostragem guardado nos valores
+double ParamEqAudioProcessor::getSnapshotDesignRate(const float* values) const noexcept
+{
+    const int factorIndex = juce::jlimit(0, NUM_OVERSAMPLING_FACTORS - 1, static_cast<int>(values[oversamplingStateIndex]));
+    return getSampleRate() * static_cast<double>(1 << factorIndex);
+}
+
+ParamEqAudioProcessor::SnapshotPtr ParamEqAudioProcessor::makeSnapshot(const float* values) const
+{
+    auto snapshot = std::make_shared<EqSnapshot>();
+    snapshot->values.assign(values, values + stateValueHandles.size());
+    snapshot->designRate = getSnapshotDesignRate(values);
+    snapshot->method = values[designMethodStateIndex] >= 0.5f ? MATCHED : BILINEAR;
+
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        const auto& indices = bandStateIndices[band];
+        std::array<float, NUM_BAND_PARAMETERS> bandValues;
+
+        for (int p = 0; p < NUM_BAND_PARAMETERS; ++p)
+            bandValues[(size_t) p] = values[indices[(size_t) p]];
+
+        auto& params = snapshot->bands[(size_t) band];
+        params = makeBandParams(bandValues);
+
+        // Sem taxa conhecida, a thread de áudio reprojeta as bandas
+        if (snapshot->designRate > 0.0)
+            snapshot->coefficients[(size_t) band] = CoefficientDesigner::design(params.type, snapshot->designRate, params.freq,
+                                                                               params.q, params.gainDb, snapshot->method);
+    }
+
+    return snapshot;
+}
+
+// Aplica os valores aos parâmetros e entrega o snapshot à thread de áudio;
+// chamado com snapshotLock
+void ParamEqAudioProcessor::switchToSnapshot(SnapshotPtr snapshot)
+{
+    setParameterValues(snapshot->values.data());
+    linearPhase.requestKernelUpdate();
+    curveWorker.requestUpdate();
+
+    // Se o pendente anterior ainda estava na fila, a thread de áudio nunca o
+    // viu e ele pode ser liberado. Caso contrário ela o pegou, e o que ela
+    // pegou antes dele já não está em uso
+    const auto* previous = pendingSnapshot.exchange(snapshot.get());
+
+    if (previous == nullptr && pendingSnapshotOwner != nullptr)
+        consumedSnapshotOwner = std::move(pendingSnapshotOwner);
+
+    pendingSnapshotOwner = std::move(snapshot);
+}
+
+void ParamEqAudioProcessor::storeSnapshot(int slot)
+{
+    if (! juce::isPositiveAndBelow(slot, NUM_SNAPSHOT_SLOTS))
+        return;
+
+    const auto values = getParameterValues();
+    const juce::ScopedLock lock(snapshotLock);
+    snapshotSlots[(size_t) slot] = makeSnapshot(values.data());
+    currentSnapshotSlot = slot;
+}
+
+bool ParamEqAudioProcessor::recallSnapshot(int slot)
+{
+    if (! juce::isPositiveAndBelow(slot, NUM_SNAPSHOT_SLOTS))
+        return false;
+
+    const juce::ScopedLock lock(snapshotLock);
+    auto& stored = snapshotSlots[(size_t) slot];
+
+    if (stored == nullptr)
+        return false;
+
+    // A taxa de amostragem mudou desde que o slot foi guardado
+    if (stored->designRate != getSnapshotDesignRate(stored->values.data()))
+        stored = makeSnapshot(stored->values.data());
+
+    currentSnapshotSlot = slot;
+    switchToSnapshot(stored);
+    return true;
+}
+
+bool ParamEqAudioProcessor::hasSnapshot(int slot) const
+{
+    const juce::ScopedLock lock(snapshotLock);
+    return juce::isPositiveAndBelow(slot, NUM_SNAPSHOT_SLOTS) && snapshotSlots[(size_t) slot] != nullptr;
+}
+
+juce::File ParamEqAudioProcessor::getDefaultPresetBankFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("ParamEQ").getChildFile("Presets.peqbank");
+}
+
+bool ParamEqAudioProcessor::loadPresetBank(const juce::File& bankFile)
+{
+    bool opened = false;
+
+    {
+        const juce::ScopedLock lock(snapshotLock);
+        opened = presetBank.open(bankFile, knownStateLayouts);
+        currentProgram = 0;
+    }
+
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    return opened;
+}
+
+// Acrescenta os parâmetros atuais ao banco aberto ou, sem banco, ao padrão
+bool ParamEqAudioProcessor::addPresetToBank(const juce::String& name)
+{
+    const auto values = getParameterValues();
+    bool added = false;
+
+    {
+        const juce::ScopedLock lock(snapshotLock);
+        const auto bankFile = presetBank.isOpen() ? presetBank.getFile() : getDefaultPresetBankFile();
+
+        if (presetBank.isOpen() && presetBank.getParameterIDs() != stateParameterIDs)
+        {
+            // Banco de um layout anterior: é regravado inteiro no layout
+            // atual, com o preset novo no fim
+            juce::StringArray names;
+            std::vector<float> bankValues;
+            std::vector<float> presetValues(static_cast<size_t>(presetBank.getNumValues()));
+
+            for (int i = 0; i < presetBank.getNumPresets(); ++i)
+            {
+                if (! presetBank.readPreset(i, presetValues.data()))
+                    continue;
+
+                const auto mapped = mapStateValues(presetBank.getParameterIDs(), presetValues.data());
+                bankValues.insert(bankValues.end(), mapped.begin(), mapped.end());
+                names.add(presetBank.getPresetName(i));
+            }
+
+            bankValues.insert(bankValues.end(), values.begin(), values.end());
+            names.add(name);
+
+            presetBank.close();
+            added = PresetBank::write(bankFile, stateParameterIDs, names, bankValues.data());
+        }
+        else
+        {
+            // O mapeamento é só de leitura: fecha, acrescenta e mapeia de novo
+            presetBank.close();
+            added = PresetBank::appendPreset(bankFile, stateParameterIDs, name, values.data());
+        }
+
+        presetBank.open(bankFile, knownStateLayouts);
+
+        if (added)
+            currentProgram = presetBank.getNumPresets() - 1;
+    }
+
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    return added;
 }
 
 //==============================================================================
@@ -407,10 +1707,3 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new ParamEqAudioProcessor();
 }
-
-
-void ParamEqAudioProcessor::updateCachedEqCurve(int numPoints, float sampleRate)
-{
-    cachedEqCurve = getEqCurve(numPoints, sampleRate);
-    eqCurveNeedsUpdate = false;
-}
\ No newline at end of file
@@ -20,6 +20,16 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_core/juce_core.h>
 #include "SpectrumAnalyzer.h"
+#include "BiquadCascade.h"
+#include "CoefficientDesigner.h"
+#include "AnalyzerFifo.h"
+#include "LinearPhaseEngine.h"
+#include "EqResponseEvaluator.h"
+#include "EqCurveWorker.h"
+#include "PerformanceTelemetry.h"
+#include "BinaryStateFormat.h"
+#include "PresetBank.h"
+#include "DynamicsDetector.h"
 
 
 //==============================================================================
@@ -38,17 +48,41 @@
 // Declaração antecipada para quebrar dependência circular
 class SpectrumAnalyzer;
 
-// Enumeração para os tipos de filtro
-enum FilterType {
-    PEAK,
-    LOW_SHELF,
-    HIGH_SHELF,
-    LOW_PASS,
-    HIGH_PASS
+// Parâmetros de cada banda, na ordem em que são criados em createParameterLayout
+enum BandParameter {
+    BAND_FREQ,
+    BAND_GAIN,
+    BAND_Q,
+    BAND_TYPE,
+    BAND_CHANNEL,
+    BAND_DYNAMIC,
+    BAND_THRESHOLD,
+    BAND_RATIO,
+    BAND_ATTACK,
+    BAND_RELEASE,
+    NUM_BAND_PARAMETERS
+};
+
+// Valores de uma banda, copiados dos parâmetros no início de cada bloco
+struct alignas(64) BandParams
+{
+    float freq = 1000.0f;
+    float gainDb = 0.0f;
+    float q = 1.0f;
+    FilterType type = PEAK;
+    int channel = BiquadCascade<float>::allChannels; // canal afetado pela banda
+
+    // Banda dinâmica: o ganho cai conforme o nível da banda passa do limiar
+    bool dynamic = false;
+    float thresholdDb = -24.0f;
+    float ratio = 2.0f;
+    float attackMs = 10.0f;
+    float releaseMs = 100.0f;
 };
 
 class ParamEqAudioProcessor  : public juce::AudioProcessor,
-                               public juce::AudioProcessorParameter::Listener
+                               public juce::AudioProcessorParameter::Listener,
+                               private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -64,6 +98,7 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
 
     //=============================== Gera o editor ================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -88,22 +123,59 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    // Restaura um estado binário ou XML; retorna false, sem alterar nada,
+    // se os dados forem inválidos
+    bool restoreState(const void* data, int sizeInBytes);
+
+    // Serializa no formato XML antigo (usado para comparação no benchmark)
+    void getXmlStateInformation(juce::MemoryBlock& destData);
+
+    // Valores de todos os parâmetros na ordem do estado, e os IDs dessa ordem
+    std::vector<float> getParameterValues() const;
+    const juce::StringArray& getStateParameterIDs() const noexcept { return stateParameterIDs; }
+
+    //============================ Snapshots e banco de presets ==============================
+    static constexpr int NUM_SNAPSHOT_SLOTS = 4; // A, B, C, D
+
+    // Guarda os parâmetros atuais no slot, com os coeficientes já projetados
+    // para a taxa atual
+    void storeSnapshot(int slot);
+
+    // A troca entrega à thread de áudio um ponteiro para o snapshot pronto;
+    // ela copia os coeficientes e faz um crossfade curto entre o estado
+    // antigo e o novo da cascata
+    bool recallSnapshot(int slot);
+    bool hasSnapshot(int slot) const;
+    int getCurrentSnapshot() const noexcept { return currentSnapshotSlot; }
+
+    // Os presets do banco são os programas do host
+    bool loadPresetBank(const juce::File& bankFile);
+    bool addPresetToBank(const juce::String& name);
+    const PresetBank& getPresetBank() const noexcept { return presetBank; }
+    static juce::File getDefaultPresetBankFile();
+
     // Sistema de parâmetros
     juce::AudioProcessorValueTreeState parameters;
 
     juce::AudioProcessorValueTreeState& getValueTreeState() { return parameters; }
 
-    bool supportsDoublePrecisionProcessing() const override { return false; }
+    bool supportsDoublePrecisionProcessing() const override { return true; }
     static constexpr int NUM_BANDS = 8;
+    static constexpr const char* OVERSAMPLING_ID = "OVERSAMPLING";
+    static constexpr int NUM_OVERSAMPLING_FACTORS = 4; // 1x, 2x, 4x, 8x
+    static constexpr const char* PHASE_MODE_ID = "PHASE_MODE";
+    static constexpr const char* LINEAR_PHASE_LENGTH_ID = "LINEAR_PHASE_LENGTH";
+    static constexpr const char* DESIGN_METHOD_ID = "DESIGN";
     static juce::String getFilterTypeName(FilterType type);
+    static juce::String getBandParameterID(BandParameter parameter, int band);
 
     void parameterValueChanged(int parameterIndex, float newValue) override;
     void parameterGestureChanged(int, bool) override {}  // não usado
 
-    // Cache de coeficientes de filtro
-    std::array<juce::dsp::IIR::Coefficients<float>::Ptr, NUM_BANDS> cachedCoefficients;
+    // Coeficientes publicados pela thread de áudio e lidos pela GUI
+    CoefficientSlots publishedCoefficients;
     std::array<std::atomic<bool>, NUM_BANDS> coefficientsDirty;
-    void updateCachedCoefficients();
+    void updateCachedCoefficients(); // apenas na thread de áudio
 
 
 
@@ -121,26 +193,104 @@ public:
         }
     }
 
-    // Espectro
-    void pushBufferToAnalyzer(const juce::AudioBuffer<float>& buffer);
-    SpectrumAnalyzer* spectrumAnalyzer = nullptr;
-
-    // Curva de equalizacao
+    // Espectro: a thread de áudio soma os canais em mono em cada ponto de
+    // captura (entrada e saída) e copia as capturas juntas para a fila sem
+    // locks; a FFT roda na thread de análise do editor
+    void captureAnalyzerTap(const juce::AudioBuffer<float>& buffer, AnalyzerTap tap) noexcept;
+    void captureAnalyzerTap(const juce::AudioBuffer<double>& buffer, AnalyzerTap tap) noexcept;
+    void pushAnalyzerTaps(int numSamples) noexcept;
+    AnalyzerFifo& getAnalyzerFifo() noexcept { return analyzerFifo; }
+    void setAnalyzerActive(bool shouldBeActive) noexcept { analyzerActive = shouldBeActive; }
+
+    // Curva de equalizacao; deve ser chamada sempre pela mesma thread (a
+    // thread da curva enquanto houver editores abertos)
     std::vector<float> getEqCurve(int numPoints, float sampleRate); // Calcula a curva
-    
-    // Sistema de cache para curva de equalização, evitando redesenhos desnecessários
-    std::atomic<bool> eqCurveNeedsUpdate { true };
-    std::vector<float> cachedEqCurve;
 
-    void updateCachedEqCurve(int numPoints, float sampleRate);
+    // A curva da GUI é calculada em segundo plano; os editores só leem o
+    // snapshot mais recente
+    EqCurveWorker& getEqCurveWorker() noexcept { return curveWorker; }
+
+   #if PARAMEQ_ENABLE_TELEMETRY
+    // Medições de processBlock, lidas pelo overlay do editor
+    PerformanceTelemetry& getTelemetry() noexcept { return telemetry; }
+   #endif
 
 private:
     //====================================Defini��o do filtro==========================================
-    std::vector<juce::dsp::ProcessorDuplicator<
-    juce::dsp::IIR::Filter<float>,
-    juce::dsp::IIR::Coefficients<float>
->> filters; // Vetor para múltiplos filtro
+    // Todas as bandas em uma única passada pelo buffer; só a cascata da
+    // precisão escolhida pelo host é preparada
+    BiquadCascade<float> floatCascade;
+    BiquadCascade<double> doubleCascade;
+
+    // Sobreamostragem opcional em volta da cascata; o índice 0 (1x) não
+    // tem sobreamostrador
+    template <typename SampleType>
+    using OversamplerSet = std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, NUM_OVERSAMPLING_FACTORS>;
+
+    OversamplerSet<float> floatOversamplers;
+    OversamplerSet<double> doubleOversamplers;
+    std::atomic<float>* oversamplingParameter = nullptr;
+    int oversamplingIndex = 0;
+    double processingSampleRate = 44100.0; // taxa em que a cascata roda
+    std::atomic<double> publishedSampleRate { 0.0 }; // taxa dos coeficientes publicados
+    std::atomic<int> pendingLatencySamples { 0 };
+
+    // Método de projeto dos coeficientes: bilinear ou casado com o analógico
+    std::atomic<float>* designMethodParameter = nullptr;
+    DesignMethod designMethod = BILINEAR;
+    DesignMethod getDesignMethodParameter() const noexcept;
+    void setDesignMethod(DesignMethod newMethod) noexcept;
+
+    void prepareOversamplers(int numChannels, int maximumBlockSize, bool useDouble);
+    void setOversamplingIndex(int newIndex) noexcept;
+    int getOversamplingLatency(int index) const noexcept;
+
+    // Modo de fase linear: o áudio passa só pelo kernel FIR montado a partir
+    // da resposta de magnitude das bandas
+    LinearPhaseEngine linearPhase { [this] { return makeLinearPhaseDesign(); } };
+    std::atomic<float>* phaseModeParameter = nullptr;
+    std::atomic<float>* linearPhaseLengthParameter = nullptr;
+    bool linearPhaseActive = false; // só passa a true com os kernels prontos
+    int linearPhaseLengthIndex = 1;
+    bool linearPhaseResourcesRequested = false;
+
+    LinearPhaseEngine::Design makeLinearPhaseDesign() const;
+    void setLinearPhaseMode(bool enabled, int lengthIndex) noexcept;
+
+    // Crossfade entre cascata e fase linear: o caminho anterior continua
+    // processando uma cópia da entrada até o fim do fade, na taxa do host
+    static constexpr double pathFadeTimeSeconds = 0.02;
+    juce::AudioBuffer<float> floatPathFadeScratch;
+    juce::AudioBuffer<double> doublePathFadeScratch;
+    int pathFadeLength = 1;
+    int pathFadeRemaining = 0;
+    bool pathFadeFromLinear = false;
+
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType>& getPathFadeScratch() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>) return floatPathFadeScratch;
+        else                                             return doublePathFadeScratch;
+    }
+
+    // A latência depende do modo de fase e do fator de sobreamostragem;
+    // mudanças feitas na thread de áudio chegam ao host pela thread de mensagens
+    int computeLatencySamples() const noexcept;
+    void updateLatency() noexcept;
+    void handleAsyncUpdate() override;
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages,
+                        BiquadCascade<SampleType>& cascade, OversamplerSet<SampleType>& oversamplers);
+
+    // Processa [startSample, startSample + numSamples) na taxa da cascata
+    template <typename SampleType>
+    void processRange(juce::AudioBuffer<SampleType>& buffer, BiquadCascade<SampleType>& cascade,
+                      juce::dsp::Oversampling<SampleType>* oversampler, int startSample, int numSamples) noexcept;
     juce::dsp::ProcessSpec spec;
+    EqResponseEvaluator responseEvaluator; // usado só por getEqCurve
+    EqCurveWorker curveWorker { [this] (int numPoints) { return computeEqCurveSnapshot(numPoints); } };
+    EqCurveWorker::Curve computeEqCurveSnapshot(int numPoints);
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParamEqAudioProcessor)
     
     // armazena os valores anteriores do filtro para otimização
@@ -151,7 +301,174 @@ private:
     std::array<std::atomic<FilterType>, NUM_BANDS> filterTypes;
     std::array<std::atomic<FilterType>, NUM_BANDS> lastFilterType;
 
-    juce::CriticalSection analyzerLock;
+    static constexpr int analyzerFifoSize = 1 << 15;
+    AnalyzerFifo analyzerFifo { analyzerFifoSize };
+    std::atomic<bool> analyzerActive { false };
+    juce::AudioBuffer<float> analyzerScratch; // um canal por captura, alocado em prepareToPlay
+
+    // Valores das bandas, gravados pelo listener antes de marcar a banda;
+    // a thread de áudio nunca precisa montar IDs em juce::String. São do
+    // processador: o valor cru da APVTS é do adaptador, que só o atualiza
+    // depois deste listener
+    std::array<std::array<std::atomic<float>, NUM_BAND_PARAMETERS>, NUM_BANDS> bandParameterValues;
+    std::vector<int> parameterIndexToBand; // índice do parâmetro -> banda
+    std::vector<int> parameterIndexToBandParameter; // índice do parâmetro -> BandParameter
+    std::vector<bool> parameterAffectsShape; // frequência, ganho, Q, tipo ou canal
+
+    // Cópia dos parâmetros feita no início de cada bloco de áudio
+    std::array<BandParams, NUM_BANDS> bandParams;
+    BandParams readBandParams(int band) const noexcept;
+    static BandParams makeBandParams(const std::array<float, NUM_BAND_PARAMETERS>& values) noexcept;
+    void takeParameterSnapshot() noexcept;
+
+    // Suavização de parâmetros: bandas em rampa têm os coeficientes
+    // recalculados a cada coefficientUpdateInterval amostras, em uma grade
+    // fixa que não depende do tamanho do buffer do host
+    static constexpr int coefficientUpdateInterval = 32;
+    static constexpr double smoothingTimeSeconds = 0.05;
+
+    struct BandSmoother
+    {
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> freq, q;
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> gainDb;
+        FilterType type = PEAK;
+        int channel = BiquadCascade<float>::allChannels;
+
+        bool isSmoothing() const noexcept { return freq.isSmoothing() || q.isSmoothing() || gainDb.isSmoothing(); }
+    };
+
+    std::array<BandSmoother, NUM_BANDS> bandSmoothers;
+    juce::uint32 rampingBands = 0; // bit n = banda n em rampa
+    int samplesUntilCoefficientUpdate = 0;
+
+    void resetSmoothers(double sampleRate);
+    void designBand(int band, FilterType type, float freq, float q, float gainDb, int channel) noexcept;
+    void setBandCoefficients(int band, const BiquadCoefficients& coeffs, int channel) noexcept;
+    std::array<float, NUM_BANDS> designedGainDb {}; // ganho dos coeficientes em uso
+
+    // Bandas dinâmicas (peak e shelves, fora do modo de fase linear): os
+    // detectores rodam em cada sub-bloco sobre a entrada ainda não
+    // processada e, na grade de coeficientes, a redução de ganho é aplicada
+    // pelo reprojeto só de ganho
+    static constexpr float maxDynamicReductionDb = 24.0f;
+    DynamicsDetector dynamicsDetector;
+    std::array<GainOnlyDesigner, NUM_BANDS> gainDesigners;
+    std::array<float, NUM_BANDS> dynamicReductionDb {};
+    juce::uint32 dynamicBands = 0; // bit n = banda n dinâmica
+
+    void configureDynamics(int band) noexcept;
+    void updateDynamicGains() noexcept;
+    float getDynamicGainDb(int band, float gainDb) const noexcept;
+
+    template <typename SampleType>
+    void runDetectors(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) noexcept;
+    void advanceSmoothing(int numSamples) noexcept;
+
+    // Lista de bandas ativas: bandas que entram ou saem fazem crossfade
+    // em vez de cortar o estado do filtro
+    static constexpr double bandFadeTimeSeconds = 0.01;
+    bool scheduleNeedsJump = true;
+    juce::uint32 activeBandMask = 0; // bit n = banda n na lista de ativas
+    void updateActiveSchedule(bool crossfade) noexcept;
+
+   #if PARAMEQ_ENABLE_TELEMETRY
+    PerformanceTelemetry telemetry;
+   #endif
+
+    // Estado: todos os parâmetros, na ordem do layout, lidos e escritos
+    // direto pelos handles. Durante uma restauração o listener ignora as
+    // notificações dos valores gravados e o recálculo é feito uma única vez
+    // no fim
+    std::vector<juce::RangedAudioParameter*> stateParameters;
+    std::vector<std::atomic<float>*> stateValueHandles;
+    juce::StringArray stateParameterIDs;
+    std::vector<float> stateDefaultValues;
+    std::atomic<int> restoringParameterIndex { -1 }; // parâmetro sendo gravado pelo lote
+    std::atomic<bool> stateRestorePending { false }; // consumido pela thread de áudio
+
+    // Layout atual e layouts anteriores, para estados e bancos da versão 1
+    // do formato, que guardavam só o hash dos IDs
+    std::vector<juce::StringArray> knownStateLayouts;
+
+    // Valores gravados com outra lista de IDs, na ordem atual
+    std::vector<float> mapStateValues(const juce::StringArray& parameterIDs, const float* values) const;
+
+    bool restoreBinaryState(const void* data, int sizeInBytes);
+    bool restoreXmlState(const void* data, int sizeInBytes);
+    void applyStateValues(const float* values);
+    void setParameterValues(const float* values); // sem acionar o listener
+
+    // Posição de cada parâmetro de banda e dos globais usados no projeto
+    // dentro do vetor de valores do estado
+    std::array<std::array<int, NUM_BAND_PARAMETERS>, NUM_BANDS> bandStateIndices {};
+    int oversamplingStateIndex = 0;
+    int designMethodStateIndex = 0;
+
+    //============================ Snapshots =====================================
+    // Valores de todos os parâmetros mais os coeficientes de cada banda,
+    // projetados na taxa da cascata para aqueles valores. Imutável depois
+    // de criado
+    struct EqSnapshot
+    {
+        std::vector<float> values;
+        std::array<BandParams, NUM_BANDS> bands;
+        std::array<BiquadCoefficients, NUM_BANDS> coefficients;
+        double designRate = 0.0;
+        DesignMethod method = BILINEAR;
+    };
+
+    using SnapshotPtr = std::shared_ptr<const EqSnapshot>;
+
+    SnapshotPtr makeSnapshot(const float* values) const;
+    double getSnapshotDesignRate(const float* values) const noexcept;
+    void switchToSnapshot(SnapshotPtr snapshot);
+
+    // Chamado pela thread de áudio com o snapshot que ela acabou de pegar
+    template <typename SampleType>
+    void applySnapshot(const EqSnapshot& snapshot, BiquadCascade<SampleType>& cascade) noexcept;
+
+    juce::CriticalSection snapshotLock; // protege slots, banco e donos dos snapshots
+    std::array<SnapshotPtr, NUM_SNAPSHOT_SLOTS> snapshotSlots;
+    int currentSnapshotSlot = -1;
+    PresetBank presetBank;
+    int currentProgram = 0;
+
+    // Entrega à thread de áudio: ela troca o ponteiro pendente por nullptr e
+    // só o lê dentro do mesmo bloco. A thread de mensagens mantém vivos o
+    // snapshot pendente e o último que a thread de áudio pegou, então a
+    // thread de áudio nunca libera memória
+    std::atomic<const EqSnapshot*> pendingSnapshot { nullptr };
+    SnapshotPtr pendingSnapshotOwner, consumedSnapshotOwner;
+
+    // Crossfade da troca: a cascata anterior continua processando uma cópia
+    // da entrada até o fim do fade. Só a precisão em uso é preparada
+    static constexpr double snapshotFadeTimeSeconds = 0.02;
+    BiquadCascade<float> floatOutgoingCascade;
+    BiquadCascade<double> doubleOutgoingCascade;
+    juce::AudioBuffer<float> floatFadeScratch;
+    juce::AudioBuffer<double> doubleFadeScratch;
+    int snapshotFadeLength = 1;
+    int snapshotFadeRemaining = 0; // amostras na taxa da cascata
+
+    template <typename SampleType>
+    BiquadCascade<SampleType>& getOutgoingCascade() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>) return floatOutgoingCascade;
+        else                                             return doubleOutgoingCascade;
+    }
+
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType>& getFadeScratch() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>) return floatFadeScratch;
+        else                                             return doubleFadeScratch;
+    }
+
+    // Processa a cascata e, durante uma troca de snapshot, mistura a saída
+    // dela com a da cascata anterior
+    template <typename SampleType>
+    void processCascade(BiquadCascade<SampleType>& cascade, SampleType* const* channels,
+                        int numChannels, int startSample, int numSamples) noexcept;
 
     // Cria layout de parametros
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -0,0 +1,264 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "PresetBank.h"
+#include "BinaryStateFormat.h"
+#include <cmath>
+#include <cstring>
+
+bool PresetBank::open(const juce::File& bankFile, const std::vector<juce::StringArray>& knownLayouts)
+{
+    close();
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(bankFile, juce::MemoryMappedFile::readOnly, false);
+    const auto* data = static_cast<const char*>(mapped->getData());
+    const auto size = mapped->getSize();
+
+    if (data == nullptr || size < (size_t) headerSize)
+        return false;
+
+    const auto version = juce::ByteOrder::littleEndianShort(data + 4);
+    const auto storedPresets = static_cast<int>(juce::ByteOrder::littleEndianInt(data + 8));
+    const auto storedValues = static_cast<int>(juce::ByteOrder::littleEndianInt(data + 12));
+    const auto layoutHash = juce::ByteOrder::littleEndianInt(data + 16);
+    const auto idTableSize = static_cast<size_t>(juce::ByteOrder::littleEndianInt(data + 20)); // zero na versão 1
+
+    if (juce::ByteOrder::littleEndianInt(data) != magic || version == 0 || version > currentVersion
+        || storedValues <= 0 || storedPresets < 0 || idTableSize > size - headerSize)
+        return false;
+
+    juce::StringArray storedIDs;
+
+    if (version == 1)
+    {
+        const auto* layout = BinaryStateFormat::findLayout(knownLayouts, layoutHash);
+        if (layout == nullptr || layout->size() != storedValues)
+            return false;
+
+        storedIDs = *layout;
+    }
+    else
+    {
+        size_t bytesRead = 0;
+        if (! BinaryStateFormat::readParameterIDs(data + headerSize, idTableSize, storedValues, storedIDs, bytesRead)
+            || BinaryStateFormat::computeLayoutHash(storedIDs) != layoutHash)
+            return false;
+    }
+
+    // Registros a mais no fim (escrita interrompida) são ignorados; a menos,
+    // o banco é rejeitado
+    const auto recordSize = static_cast<size_t>(nameSize + storedValues * (int) sizeof(float));
+    if (size < headerSize + idTableSize + static_cast<size_t>(storedPresets) * recordSize)
+        return false;
+
+    file = bankFile;
+    mappedFile = std::move(mapped);
+    parameterIDs = std::move(storedIDs);
+    numPresets = storedPresets;
+    numValues = storedValues;
+    recordsOffset = headerSize + idTableSize;
+    return true;
+}
+
+void PresetBank::close() noexcept
+{
+    mappedFile.reset();
+    file = juce::File();
+    parameterIDs.clear();
+    numPresets = 0;
+    numValues = 0;
+    recordsOffset = headerSize;
+}
+
+const char* PresetBank::getRecord(int index) const noexcept
+{
+    if (mappedFile == nullptr || ! juce::isPositiveAndBelow(index, numPresets))
+        return nullptr;
+
+    return static_cast<const char*>(mappedFile->getData()) + recordsOffset + static_cast<size_t>(index) * (size_t) getRecordSize();
+}
+
+juce::String PresetBank::getPresetName(int index) const
+{
+    const auto* record = getRecord(index);
+    if (record == nullptr)
+        return {};
+
+    return juce::String::fromUTF8(record, (int) strnlen(record, nameSize));
+}
+
+bool PresetBank::readPreset(int index, float* values) const noexcept
+{
+    const auto* record = getRecord(index);
+    if (record == nullptr)
+        return false;
+
+    const auto* payload = record + nameSize;
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        const juce::uint32 bits = juce::ByteOrder::littleEndianInt(payload + i * (int) sizeof(float));
+        std::memcpy(values + i, &bits, sizeof(bits));
+
+        if (! std::isfinite(values[i]))
+            return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+void PresetBank::writeHeader(juce::OutputStream& out, const juce::StringArray& parameterIDs, int numPresets)
+{
+    juce::MemoryOutputStream idTable;
+    BinaryStateFormat::writeParameterIDs(idTable, parameterIDs);
+
+    // Os registros começam alinhados a 4 bytes
+    while (idTable.getDataSize() % 4 != 0)
+        idTable.writeByte(0);
+
+    // OutputStream escreve sempre em little-endian
+    out.writeInt(static_cast<int>(magic));
+    out.writeShort(static_cast<short>(currentVersion));
+    out.writeShort(0);
+    out.writeInt(numPresets);
+    out.writeInt(parameterIDs.size());
+    out.writeInt(static_cast<int>(BinaryStateFormat::computeLayoutHash(parameterIDs)));
+    out.writeInt(static_cast<int>(idTable.getDataSize()));
+
+    for (int i = 24; i < headerSize; ++i)
+        out.writeByte(0);
+
+    out.write(idTable.getData(), idTable.getDataSize());
+}
+
+void PresetBank::writeRecord(juce::OutputStream& out, const juce::String& name, const float* values, int numValuesPerPreset)
+{
+    char nameBytes[nameSize] = {};
+    name.copyToUTF8(nameBytes, nameSize); // trunca e mantém o terminador
+    out.write(nameBytes, nameSize);
+
+    for (int i = 0; i < numValuesPerPreset; ++i)
+        out.writeFloat(values[i]);
+}
+
+bool PresetBank::write(const juce::File& bankFile, const juce::StringArray& parameterIDs,
+                       const juce::StringArray& names, const float* values)
+{
+    const int numValuesPerPreset = parameterIDs.size();
+
+    // Escreve em um arquivo temporário e só então substitui o banco
+    juce::TemporaryFile temp(bankFile);
+
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (! out.openedOk())
+            return false;
+
+        writeHeader(out, parameterIDs, names.size());
+
+        for (int i = 0; i < names.size(); ++i)
+            writeRecord(out, names[i], values + static_cast<size_t>(i) * (size_t) numValuesPerPreset, numValuesPerPreset);
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+bool PresetBank::appendPreset(const juce::File& bankFile, const juce::StringArray& parameterIDs,
+                              const juce::String& name, const float* values)
+{
+    if (! bankFile.existsAsFile())
+    {
+        bankFile.getParentDirectory().createDirectory();
+        return write(bankFile, parameterIDs, juce::StringArray(name), values);
+    }
+
+    const int numValuesPerPreset = parameterIDs.size();
+    int storedPresets = 0;
+    juce::int64 idTableSize = 0;
+
+    {
+        juce::FileInputStream in(bankFile);
+        if (! in.openedOk() || in.getTotalLength() < headerSize)
+            return false;
+
+        const auto fileMagic = static_cast<juce::uint32>(in.readInt());
+        const auto version = static_cast<juce::uint16>(in.readShort());
+        in.readShort();
+        storedPresets = in.readInt();
+        const auto storedValues = in.readInt();
+        const auto storedHash = static_cast<juce::uint32>(in.readInt());
+        idTableSize = static_cast<juce::uint32>(in.readInt());
+
+        if (fileMagic != magic || version == 0 || version > currentVersion || storedValues != numValuesPerPreset
+            || storedHash != BinaryStateFormat::computeLayoutHash(parameterIDs) || storedPresets < 0)
+            return false;
+    }
+
+    juce::FileOutputStream out(bankFile);
+    if (! out.openedOk())
+        return false;
+
+    // O registro vai logo depois do último preset válido e só então o
+    // contador do cabeçalho é atualizado
+    const auto recordSize = static_cast<juce::int64>(nameSize + numValuesPerPreset * (int) sizeof(float));
+    out.setPosition(headerSize + idTableSize + storedPresets * recordSize);
+    writeRecord(out, name, values, numValuesPerPreset);
+    out.flush();
+
+    out.setPosition(8);
+    out.writeInt(storedPresets + 1);
+    out.flush();
+    return ! out.getStatus().failed();
+}
+
+bool PresetBank::renamePreset(const juce::File& bankFile, int index, const juce::String& newName)
+{
+    int storedPresets = 0, storedValues = 0;
+    juce::int64 idTableSize = 0;
+
+    {
+        juce::FileInputStream in(bankFile);
+        if (! in.openedOk() || in.getTotalLength() < headerSize || static_cast<juce::uint32>(in.readInt()) != magic)
+            return false;
+
+        in.setPosition(8);
+        storedPresets = in.readInt();
+        storedValues = in.readInt();
+        in.readInt();
+        idTableSize = static_cast<juce::uint32>(in.readInt());
+    }
+
+    if (! juce::isPositiveAndBelow(index, storedPresets))
+        return false;
+
+    juce::FileOutputStream out(bankFile);
+    if (! out.openedOk())
+        return false;
+
+    char nameBytes[nameSize] = {};
+    newName.copyToUTF8(nameBytes, nameSize);
+
+    const auto recordSize = static_cast<juce::int64>(nameSize + storedValues * (int) sizeof(float));
+    out.setPosition(headerSize + idTableSize + index * recordSize);
+    out.write(nameBytes, nameSize);
+    out.flush();
+    return ! out.getStatus().failed();
+}
@@ -0,0 +1,97 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/** Banco de presets em um arquivo mapeado em memória.
+
+    O arquivo pode ter milhares de presets; abrir o banco só valida o
+    cabeçalho e mapeia o arquivo, e cada preset é lido sob demanda.
+
+    Layout (little-endian):
+        cabeçalho de headerSize bytes:
+            uint32  magic ("PEQB")
+            uint16  versão do formato
+            uint16  reservado
+            uint32  número de presets
+            uint32  número de valores por preset
+            uint32  hash dos IDs dos parâmetros (o mesmo do estado binário)
+            uint32  tamanho da tabela de IDs, múltiplo de 4 (versão 2)
+        tabela de IDs no formato do estado binário, completada com zeros
+        registros de tamanho fixo, um por preset:
+            nome em UTF-8, completado com zeros até nameSize bytes
+            float   valor de cada parâmetro, na unidade do parâmetro
+
+    Os valores seguem a ordem da tabela de IDs, e quem lê o banco os aplica
+    por ID. A versão 1 não tinha a tabela: seus IDs são encontrados pelo
+    hash entre os layouts conhecidos.
+
+    Os presets guardam só os valores: os coeficientes dependem da taxa de
+    amostragem e são projetados quando o preset é carregado.
+*/
+class PresetBank
+{
+public:
+    static constexpr juce::uint32 magic = 0x42514550; // "PEQB" em little-endian
+    static constexpr juce::uint16 currentVersion = 2;
+    static constexpr int headerSize = 32;
+    static constexpr int nameSize = 32;
+
+    // Mapeia o arquivo; falha se ele não existir, não for um banco ou for
+    // da versão 1 com um layout que não está em knownLayouts
+    bool open(const juce::File& bankFile, const std::vector<juce::StringArray>& knownLayouts);
+    void close() noexcept;
+
+    bool isOpen() const noexcept { return mappedFile != nullptr; }
+    const juce::File& getFile() const noexcept { return file; }
+    int getNumPresets() const noexcept { return numPresets; }
+
+    // IDs dos valores de cada preset, na ordem em que foram gravados
+    const juce::StringArray& getParameterIDs() const noexcept { return parameterIDs; }
+    int getNumValues() const noexcept { return numValues; }
+
+    juce::String getPresetName(int index) const;
+
+    // Copia os getNumValues() valores do preset; retorna false se o índice
+    // for inválido ou se algum valor não for finito
+    bool readPreset(int index, float* values) const noexcept;
+
+    // Escrita: o banco não pode estar aberto sobre o mesmo arquivo.
+    // appendPreset falha se o banco existente tiver outro layout
+    static bool write(const juce::File& bankFile, const juce::StringArray& parameterIDs,
+                      const juce::StringArray& names, const float* values);
+    static bool appendPreset(const juce::File& bankFile, const juce::StringArray& parameterIDs,
+                             const juce::String& name, const float* values);
+    static bool renamePreset(const juce::File& bankFile, int index, const juce::String& newName);
+
+private:
+    int getRecordSize() const noexcept { return nameSize + numValues * (int) sizeof(float); }
+    const char* getRecord(int index) const noexcept;
+
+    static void writeHeader(juce::OutputStream& out, const juce::StringArray& parameterIDs, int numPresets);
+    static void writeRecord(juce::OutputStream& out, const juce::String& name, const float* values, int numValuesPerPreset);
+
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    juce::StringArray parameterIDs;
+    int numPresets = 0;
+    int numValues = 0;
+    size_t recordsOffset = headerSize;
+};
@@ -0,0 +1,259 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "SpectrumAnalysisWorker.h"
+
+SpectrumAnalysisWorker::SpectrumAnalysisWorker(AnalyzerFifo& source, AnalysisService& service)
+    : fifo(source),
+      analysisService(service),
+      fftBuffer(static_cast<size_t>(maxFftSize * 2), 0.0f),
+      packedTime(static_cast<size_t>(maxFftSize)),
+      packedSpectrum(static_cast<size_t>(maxFftSize)),
+      peaks(static_cast<size_t>(maxNumBins), 0.0f)
+{
+    for (int tap = 0; tap < NUM_ANALYZER_TAPS; ++tap)
+    {
+        inputBuffers[(size_t) tap].assign(static_cast<size_t>(maxFftSize), 0.0f);
+        magnitudes[(size_t) tap].assign(static_cast<size_t>(maxNumBins), 0.0f);
+        averaged[(size_t) tap].assign(static_cast<size_t>(maxNumBins), 0.0f);
+    }
+
+    Frame emptyFrame;
+    for (auto& tapMagnitudes : emptyFrame.magnitudes)
+        tapMagnitudes.assign(static_cast<size_t>(maxNumBins), 0.0f);
+    emptyFrame.peaks.assign(static_cast<size_t>(maxNumBins), 0.0f);
+    frames.fill(emptyFrame);
+    analysisService.addWorker(this);
+    fifo.setConsumer(this);
+}
+
+SpectrumAnalysisWorker::~SpectrumAnalysisWorker()
+{
+    fifo.setConsumer(nullptr);
+    analysisService.removeWorker(this);
+}
+
+void SpectrumAnalysisWorker::setEnabled(bool shouldBeEnabled) noexcept
+{
+    const bool wasEnabled = enabled.load();
+
+    if (shouldBeEnabled && ! wasEnabled)
+        restartPending = true;
+
+    enabled = shouldBeEnabled;
+
+    if (shouldBeEnabled && ! wasEnabled)
+        analysisService.notifyWorkPending();
+}
+
+bool SpectrumAnalysisWorker::hasPendingWork() const noexcept
+{
+    return enabled.load(std::memory_order_relaxed)
+        && (restartPending.load(std::memory_order_relaxed)
+            || settingsChanged.load(std::memory_order_relaxed)
+            || fifo.getNumReady() > 0);
+}
+
+bool SpectrumAnalysisWorker::tryClaim() noexcept
+{
+    bool expected = false;
+    return busy.compare_exchange_strong(expected, true, std::memory_order_acquire);
+}
+
+void SpectrumAnalysisWorker::setSettings(const Settings& newSettings)
+{
+    const juce::SpinLock::ScopedLockType lock(settingsLock);
+    pendingSettings = newSettings;
+    settingsChanged = true;
+    analysisService.notifyWorkPending();
+}
+
+SpectrumAnalysisWorker::Settings SpectrumAnalysisWorker::getSettings() const
+{
+    const juce::SpinLock::ScopedLockType lock(settingsLock);
+    return pendingSettings;
+}
+
+// Recria FFT e janela apenas quando o tamanho muda; média e pico recomeçam
+void SpectrumAnalysisWorker::applySettings()
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(settingsLock);
+        settings = pendingSettings;
+    }
+
+    settings.fftOrder = juce::jlimit(minFftOrder, maxFftOrder, settings.fftOrder);
+    const int newFftSize = 1 << settings.fftOrder;
+
+    if (newFftSize != fftSize)
+    {
+        fftSize = newFftSize;
+        numBins = fftSize / 2;
+        plan = &analysisService.getPlan(settings.fftOrder);
+
+        for (auto& buffer : inputBuffers)
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+    }
+
+    hopSize = juce::jlimit(1, fftSize, fftSize / juce::jmax(1, settings.overlap));
+
+    // O primeiro quadro sai depois de um hop, com o começo do buffer em zero
+    inputIndex = fftSize - hopSize;
+    hasAverage = false;
+    std::fill(peaks.begin(), peaks.end(), 0.0f);
+}
+
+// Processa todos os quadros que a fila permitir; só a thread que pegou a
+// análise chega aqui
+void SpectrumAnalysisWorker::processPendingWork()
+{
+    // Descarta o que sobrou na fila de uma sessão anterior do analisador
+    if (restartPending.exchange(false))
+    {
+        fifo.discardAll();
+        settingsChanged = true;
+    }
+
+    if (settingsChanged.exchange(false))
+        applySettings();
+
+    while (enabled.load(std::memory_order_relaxed) && fifo.getNumReady() > 0)
+    {
+        // Todas as capturas avançam juntas
+        float* destinations[NUM_ANALYZER_TAPS];
+        for (int tap = 0; tap < NUM_ANALYZER_TAPS; ++tap)
+            destinations[tap] = inputBuffers[(size_t) tap].data() + inputIndex;
+
+        inputIndex += fifo.pop(destinations, fftSize - inputIndex);
+
+        if (inputIndex >= fftSize)
+        {
+            processFrame();
+
+            // Mantém as fftSize - hopSize amostras mais recentes para o próximo quadro
+            for (auto& buffer : inputBuffers)
+                std::copy(buffer.begin() + hopSize, buffer.begin() + fftSize, buffer.begin());
+
+            inputIndex = fftSize - hopSize;
+        }
+    }
+
+    // O próximo aviso da fila só vem com o quadro seguinte completo; o que
+    // chegar antes deste pedido é visto pela thread ao procurar trabalho
+    fifo.requestSamples(fftSize - inputIndex);
+}
+
+// Só a saída: FFT real de magnitude
+void SpectrumAnalysisWorker::transformOutputOnly()
+{
+    const auto& output = inputBuffers[OUTPUT_TAP];
+    std::copy(output.begin(), output.begin() + fftSize, fftBuffer.begin());
+
+    // Aplica janela de Hann (tabela do plano compartilhado)
+    juce::FloatVectorOperations::multiply(fftBuffer.data(), plan->window.data(), fftSize);
+
+    plan->fft.performFrequencyOnlyForwardTransform(fftBuffer.data());
+    juce::FloatVectorOperations::multiply(magnitudes[OUTPUT_TAP].data(), fftBuffer.data(), 1.0f / fftSize, numBins);
+}
+
+// Entrada e saída em uma única FFT complexa: z = x + i y. Com Z[k] a
+// transformada de z, X[k] = (Z[k] + conj(Z[N - k])) / 2 e
+// Y[k] = (Z[k] - conj(Z[N - k])) / 2i
+void SpectrumAnalysisWorker::transformInputAndOutput()
+{
+    // Janela aplicada às duas capturas, lado a lado no buffer real
+    float* windowedInput = fftBuffer.data();
+    float* windowedOutput = fftBuffer.data() + fftSize;
+    std::copy(inputBuffers[INPUT_TAP].begin(), inputBuffers[INPUT_TAP].begin() + fftSize, windowedInput);
+    std::copy(inputBuffers[OUTPUT_TAP].begin(), inputBuffers[OUTPUT_TAP].begin() + fftSize, windowedOutput);
+    juce::FloatVectorOperations::multiply(windowedInput, plan->window.data(), fftSize);
+    juce::FloatVectorOperations::multiply(windowedOutput, plan->window.data(), fftSize);
+
+    for (int n = 0; n < fftSize; ++n)
+        packedTime[(size_t) n] = { windowedInput[n], windowedOutput[n] };
+
+    plan->fft.perform(packedTime.data(), packedSpectrum.data(), false);
+
+    // |Z + conj(Zr)| / 2 e |Z - conj(Zr)| / 2, já com a normalização 1 / N
+    const float scale = 0.5f / fftSize;
+    float* inputMagnitudes = magnitudes[INPUT_TAP].data();
+    float* outputMagnitudes = magnitudes[OUTPUT_TAP].data();
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto z = packedSpectrum[(size_t) k];
+        const auto mirrored = std::conj(packedSpectrum[(size_t) ((fftSize - k) & (fftSize - 1))]);
+
+        inputMagnitudes[k] = std::abs(z + mirrored) * scale;
+        outputMagnitudes[k] = std::abs(z - mirrored) * scale;
+    }
+}
+
+// Calcula a FFT de um quadro completo e publica as magnitudes
+void SpectrumAnalysisWorker::processFrame()
+{
+    if (settings.showInput)
+        transformInputAndOutput();
+    else
+        transformOutputOnly();
+
+    const int firstTap = settings.showInput ? 0 : (int) OUTPUT_TAP;
+
+    // Média exponencial por hop: a = 1 - exp(-hop / (tau * fs))
+    const double hopSeconds = hopSize / juce::jmax(1.0, sampleRate.load(std::memory_order_relaxed));
+    const bool smooth = settings.averagingSeconds > 0.0f && hasAverage;
+    const auto alpha = smooth ? static_cast<float>(1.0 - std::exp(-hopSeconds / settings.averagingSeconds)) : 1.0f;
+
+    for (int tap = firstTap; tap < NUM_ANALYZER_TAPS; ++tap)
+    {
+        auto* average = averaged[(size_t) tap].data();
+
+        if (smooth)
+        {
+            juce::FloatVectorOperations::multiply(average, 1.0f - alpha, numBins);
+            juce::FloatVectorOperations::addWithMultiply(average, magnitudes[(size_t) tap].data(), alpha, numBins);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copy(average, magnitudes[(size_t) tap].data(), numBins);
+        }
+    }
+
+    hasAverage = true;
+
+    // Pico: decai a uma taxa fixa em dB/s e nunca fica abaixo da média
+    if (settings.peakHold)
+    {
+        const auto decay = static_cast<float>(juce::Decibels::decibelsToGain(-settings.peakDecayDbPerSecond * hopSeconds));
+        juce::FloatVectorOperations::multiply(peaks.data(), decay, numBins);
+        juce::FloatVectorOperations::max(peaks.data(), peaks.data(), averaged[OUTPUT_TAP].data(), numBins);
+    }
+
+    // Publica direto no buffer de escrita, já alocado com o tamanho máximo
+    auto& frame = frames.getWriteBuffer();
+
+    for (int tap = firstTap; tap < NUM_ANALYZER_TAPS; ++tap)
+        juce::FloatVectorOperations::copy(frame.magnitudes[(size_t) tap].data(), averaged[(size_t) tap].data(), numBins);
+
+    if (settings.peakHold)
+        juce::FloatVectorOperations::copy(frame.peaks.data(), peaks.data(), numBins);
+
+    frame.fftSize = fftSize;
+    frame.numBins = numBins;
+    frame.hasPeaks = settings.peakHold;
+    frame.hasInput = settings.showInput;
+    frames.publish();
+}
@@ -0,0 +1,144 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "AnalysisService.h"
+#include "AnalyzerFifo.h"
+#include "TripleBuffer.h"
+
+//==============================================================================
+/** Análise de espectro de um editor, executada pelas threads do
+    AnalysisService compartilhado.
+
+    Consome as amostras que a thread de áudio escreve na AnalyzerFifo e
+    executa uma STFT com tamanho e sobreposição configuráveis: a cada hop
+    novo, as últimas fftSize amostras recebem a janela de Hann e passam pela
+    FFT; plano e janela vêm do serviço e são os mesmos para todas as
+    instâncias. As magnitudes
+    podem ser suavizadas por uma média exponencial e acompanhadas de um
+    traço de pico com decaimento lento, tudo em buffers pré-alocados.
+    A GUI só lê o quadro publicado mais recente.
+
+    Com a captura de entrada ligada, entrada e saída são reais e passam
+    juntas por uma única FFT complexa (entrada na parte real, saída na
+    imaginária); os dois espectros são separados pela simetria conjugada,
+    então a entrada custa pouco mais que a separação.
+*/
+class SpectrumAnalysisWorker : private AnalyzerFifo::Consumer
+{
+public:
+    static constexpr int minFftOrder = 10;
+    static constexpr int maxFftOrder = 15;
+    static constexpr int maxFftSize = 1 << maxFftOrder;
+    static constexpr int maxNumBins = maxFftSize / 2;
+
+    struct Settings
+    {
+        int fftOrder = 12;              // 2^fftOrder amostras por quadro
+        int overlap = 4;                // quadros por fftSize amostras (hop = fftSize / overlap)
+        float averagingSeconds = 0.1f;  // constante de tempo da média; 0 desliga
+        bool peakHold = false;
+        bool showInput = false;         // analisa também a captura de entrada
+        float peakDecayDbPerSecond = 6.0f;
+    };
+
+    // Quadro publicado; os vetores têm sempre maxNumBins posições, das quais
+    // só as numBins primeiras são válidas. O pico acompanha a saída
+    struct Frame
+    {
+        std::array<std::vector<float>, NUM_ANALYZER_TAPS> magnitudes;
+        std::vector<float> peaks;
+        int fftSize = 0;
+        int numBins = 0;
+        bool hasPeaks = false;
+        bool hasInput = false;
+    };
+
+    SpectrumAnalysisWorker(AnalyzerFifo& source, AnalysisService& service);
+    ~SpectrumAnalysisWorker() override;
+
+    // Chamado pela GUI: sem análise habilitada, as threads do serviço a
+    // ignoram; ao habilitar, o que sobrou na fila é descartado
+    void setEnabled(bool shouldBeEnabled) noexcept;
+
+    // Usados pelas threads do serviço: apenas uma thread por vez pega a
+    // análise e processa todos os quadros disponíveis
+    bool hasPendingWork() const noexcept;
+    bool tryClaim() noexcept;
+    void release() noexcept { busy.store(false, std::memory_order_release); }
+    bool isBusy() const noexcept { return busy.load(std::memory_order_acquire); }
+    void processPendingWork();
+
+    // Chamados pela GUI: a nova configuração é aplicada pela própria thread
+    void setSettings(const Settings& newSettings);
+    Settings getSettings() const;
+    void setSampleRate(double newSampleRate) noexcept { sampleRate = newSampleRate; }
+
+    // Chamados pela GUI: troca para o quadro mais recente, se houver
+    bool acquireLatestFrame() noexcept { return frames.acquireLatest(); }
+    const Frame& getLatestFrame() const noexcept { return frames.getReadBuffer(); }
+
+private:
+    // Thread de áudio: a fila tem as amostras do próximo quadro
+    void samplesReady() noexcept override { analysisService.notifyWorkPending(); }
+
+    void applySettings();
+    void processFrame();
+    void transformOutputOnly();
+    void transformInputAndOutput();
+
+    AnalyzerFifo& fifo;
+    AnalysisService& analysisService;
+
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> restartPending { false };
+    std::atomic<bool> busy { false };
+
+    // Configuração pedida pela GUI
+    mutable juce::SpinLock settingsLock;
+    Settings pendingSettings;
+    std::atomic<bool> settingsChanged { true };
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // Configuração em uso; só a thread de análise acessa
+    Settings settings;
+    int fftSize = 0;
+    int numBins = 0;
+    int hopSize = 0;
+
+    const AnalysisService::FftPlan* plan = nullptr; // compartilhado, pertence ao serviço
+
+    using Complex = juce::dsp::Complex<float>;
+
+    std::array<std::vector<float>, NUM_ANALYZER_TAPS> inputBuffers; // últimas fftSize amostras de cada captura
+    std::vector<float> fftBuffer;                                   // 2 * fftSize, exigido pela FFT da JUCE
+    std::vector<Complex> packedTime, packedSpectrum;                // FFT conjunta de entrada e saída
+    std::array<std::vector<float>, NUM_ANALYZER_TAPS> magnitudes;   // quadro atual, antes da média
+    std::array<std::vector<float>, NUM_ANALYZER_TAPS> averaged;     // média exponencial das magnitudes
+    std::vector<float> peaks;                                       // pico da saída, com decaimento
+    int inputIndex = 0;
+    bool hasAverage = false;
+
+    TripleBuffer<Frame> frames;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalysisWorker)
+};
\ No newline at end of file
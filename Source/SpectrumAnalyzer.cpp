@@ -15,139 +15,253 @@
 // along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "SpectrumAnalyzer.h"
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    // log10 aproximado, sem chamadas à libm: expoente lido dos bits do float e
+    // polinômio de grau 5 para log2 da mantissa em [1, 2) (erro < 0,0002 dB).
+    // O laço não tem desvios e o compilador o vetoriza; os valores chegam
+    // já limitados a um intervalo positivo e normalizado
+    void log10Levels(float* levels, int numValues) noexcept {
+        constexpr float c1 = 1.4418259f, c2 = -0.7086829f, c3 = 0.4154247f, c4 = -0.1944264f, c5 = 0.0458872f;
+        constexpr float log10Of2 = 0.30102999566f;
+
+        for (int i = 0; i < numValues; ++i) {
+            std::uint32_t bits;
+            std::memcpy(&bits, levels + i, sizeof(bits));
+
+            const auto exponent = static_cast<float>(static_cast<std::int32_t>(bits >> 23) - 127);
+            bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+            float mantissa;
+            std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+            const float t = mantissa - 1.0f;
+            const float log2Mantissa = t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * c5))));
+            levels[i] = (exponent + log2Mantissa) * log10Of2;
+        }
+    }
+}
 
 SpectrumAnalyzer::SpectrumAnalyzer(ParamEqAudioProcessor& p) 
     : processor(p),
-      forwardFFT(fftOrder),
-      fftBuffer(1, fftSize * 2),  // 1 canal, 2*fftSize samples
-      fifoBuffer(1, fftSize)      // 1 canal, fftSize samples
+      analysisWorker(p.getAnalyzerFifo(), *analysisService)
 {
-    setBufferedToImage(true); // Habilita double buffering
-    startTimerHz(40); // Atualização a 40 FPS
+    // Grade e curva ficam em imagens próprias; só o espectro é redesenhado a cada quadro
     setOpaque(true);
-    fftBuffer.clear();
-    fifoBuffer.clear();
-    fftBuffer.clear();
+
+    // O timer do serviço (40 FPS) é compartilhado por todos os editores
+    analysisWorker.setSampleRate(processor.getSampleRate());
+    analysisService->addListener(this);
+
+   #if PARAMEQ_ENABLE_TELEMETRY
+    addChildComponent(telemetryOverlay);
+   #endif
 }
 
 SpectrumAnalyzer::~SpectrumAnalyzer() {
-    stopTimer(); // Para o timer antes de destruir
-    juce::ScopedLock sl(bufferLock);
+    analysisService->removeListener(this);
+    setAnalysisActive(false);
 }
 
-// Alimenta o analisador com um buffer já normalizado
-void SpectrumAnalyzer::pushBuffer(const juce::AudioBuffer<float>& buffer) {
-    const int numSamples = buffer.getNumSamples();
-    if (numSamples <= 0) return;
+// Renderização do espectro e curva de equalização
+void SpectrumAnalyzer::paint(juce::Graphics& g) {
+    // As camadas são refeitas se a escala da tela mudou (outro monitor, zoom)
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-    const float* channelData = buffer.getReadPointer(0);
-    for (int i = 0; i < numSamples; ++i) {
-        pushSample(channelData[i]);
+    if (gridLayer.isNull() || scale != layerScale) {
+        layerScale = scale;
+        renderGridLayer();
+        eqCurveLayerDirty = true;
     }
-}
 
-// Processamento individual de amostras
-void SpectrumAnalyzer::pushSample(float sample) {
-    jassert(fifoIndex >= 0 && fifoIndex < fftSize);
-    // Escreve no buffer FIFO de forma segura
-    const juce::ScopedLock sl(bufferLock);
-    fifoBuffer.setSample(0, fifoIndex, sample);
-
-    if (++fifoIndex >= fftSize) {
-        fifoIndex = 0;
-        nextFFTBlockReady = true;
-        processFFT();
-    }
-}
+    if (eqCurveLayerDirty)
+        renderEqCurveLayer();
 
-// Calcula a FFT
-void SpectrumAnalyzer::processFFT() {
-    // Aplica um lock nos ponteiros de escrita e leitura do buffer FIFO
-    {
-        juce::ScopedLock sl(bufferLock);
-        std::memcpy(
-            fftBuffer.getWritePointer(0),
-            fifoBuffer.getReadPointer(0),
-            fftSize * sizeof(float)
-        );
-    }
+    const auto layerBounds = getLocalBounds().toFloat();
 
-    // Aplica janela de Hann (fora do lock para evitar bloqueios)
-    juce::dsp::WindowingFunction<float> window(fftSize, juce::dsp::WindowingFunction<float>::hann);
-    window.multiplyWithWindowingTable(fftBuffer.getWritePointer(0), fftSize);
+    // Fundo preto e grades de referência
+    g.drawImage(gridLayer, layerBounds);
 
-    // Executa FFT
-    forwardFFT.performFrequencyOnlyForwardTransform(fftBuffer.getWritePointer(0));
+    // Obtém e desenha o espectro de áudio (último quadro publicado pela análise)
+    const auto& frame = analysisWorker.getLatestFrame();
 
-    // Normaliza os valores da FFT
-    for (int i = 0; i < fftSize; ++i) {
-    fftBuffer.getWritePointer(0)[i] /= fftSize;
+    // Entrada, antes do equalizador, por baixo da saída
+    if (frame.hasInput) {
+        createFrequencyPlotPath(inputPath, getLocalBounds(), frame.magnitudes[INPUT_TAP].data());
+        g.setColour(juce::Colours::grey.withAlpha(0.35f));
+        g.fillPath(inputPath);
+        g.setColour(juce::Colours::lightgrey.withAlpha(0.6f));
+        g.strokePath(inputPath, juce::PathStrokeType(1.0f));
     }
 
-    nextFFTBlockReady = true;
-}
+    createFrequencyPlotPath(spectrumPath, getLocalBounds(), frame.magnitudes[OUTPUT_TAP].data());
+    g.setColour(juce::Colours::cyan.withAlpha(0.7f));
+    g.fillPath(spectrumPath);
 
-// Renderização do espectro e curva de equalização
-void SpectrumAnalyzer::paint(juce::Graphics& g) {
-    // Fundo preto
-    g.fillAll(juce::Colours::black);
+    // Curva de equalização já rasterizada
+    g.drawImage(eqCurveLayer, layerBounds);
 
-    // Desenha as grades de referência
-    drawDbGrid(g, getLocalBounds());        // horizontais
-    drawFrequencyGrid(g, getLocalBounds()); //verticais
+    // Desenha o contorno do espectro
+    g.setColour(juce::Colours::white);
+    g.strokePath(spectrumPath, juce::PathStrokeType(1.0f));
 
-    // Obtém e desenha o espectro de áudio (com lock)
-    juce::Path local_SpectrumPath;
-    {
-        juce::ScopedLock sl(bufferLock);
-        createFrequencyPlotPath(local_SpectrumPath, getLocalBounds());
+    // Traço de pico, se ativado
+    if (frame.hasPeaks) {
+        createFrequencyPlotPath(peakPath, getLocalBounds(), frame.peaks.data());
+        g.setColour(juce::Colours::orange.withAlpha(0.8f));
+        g.strokePath(peakPath, juce::PathStrokeType(1.0f));
     }
-    g.setColour(juce::Colours::cyan.withAlpha(0.7f));
-    g.fillPath(local_SpectrumPath);
+}
 
-    // Obtém a curva de equalização
-   createEQCurvePlot(g, getLocalBounds());
+// Monta a tabela de bins por pixel para a escala logarítmica de 20 Hz a 20 kHz
+void SpectrumAnalyzer::updatePixelMap(int width, double sampleRate, int fftSize) {
+    if (width == mappedWidth && sampleRate == mappedSampleRate && fftSize == mappedFftSize)
+        return;
 
-    // Desenha o contorno do espectro
-    g.setColour(juce::Colours::white);
-    g.strokePath(local_SpectrumPath, juce::PathStrokeType(1.0f));
+    mappedWidth = width;
+    mappedSampleRate = sampleRate;
+    mappedFftSize = fftSize;
+
+    pixelMap.assign(static_cast<size_t>(width), {});
+    pixelLevels.assign(static_cast<size_t>(width), 0.0f);
+
+    const int numBins = fftSize / 2;
+    const double binsPerHz = fftSize / sampleRate;
+    const double decades = std::log10(20000.0 / 20.0);
+    auto pixelToBin = [&](double x) { return 20.0 * std::pow(10.0, x / width * decades) * binsPerHz; };
+
+    for (int x = 0; x < width; ++x) {
+        auto& entry = pixelMap[static_cast<size_t>(x)];
+        const double centre = pixelToBin(x);
+
+        if (centre >= numBins - 1)
+            continue; // acima de Nyquist
+
+        // Bins inteiros dentro de [x - 0.5, x + 0.5)
+        const int first = juce::jmax(1, static_cast<int>(std::ceil(pixelToBin(x - 0.5))));
+        const int last = juce::jmin(numBins - 1, static_cast<int>(std::ceil(pixelToBin(x + 0.5))) - 1);
+
+        entry.valid = true;
+
+        if (last >= first) {
+            entry.firstBin = first;
+            entry.numBins = last - first + 1;
+        } else {
+            entry.firstBin = static_cast<int>(centre);
+            entry.fraction = static_cast<float>(centre - entry.firstBin);
+        }
+    }
 }
 
-// Cria o caminho para o gráfico de frequência
-void SpectrumAnalyzer::createFrequencyPlotPath(juce::Path& path, const juce::Rectangle<int> bounds) {
+// Cria o caminho para o gráfico de frequência, com no máximo um ponto por pixel
+void SpectrumAnalyzer::createFrequencyPlotPath(juce::Path& path, const juce::Rectangle<int> bounds, const float* magnitudes) {
     path.clear();
-    path.startNewSubPath(bounds.getX(), bounds.getBottom());
-    
-    const float sampleRate = processor.getSampleRate();
-    const float xScale = bounds.getWidth() / std::log10(20000.0f / 20.0f);
-    // Obtém o ponteiro de leitura do buffer FFT
-    const float* fftData = fftBuffer.getReadPointer(0);
+
+    // Tamanho do quadro mais recente (muda com a configuração da análise)
+    const auto& frame = analysisWorker.getLatestFrame();
+    const int width = bounds.getWidth();
+
+    if (frame.numBins == 0 || width <= 0)
+        return;
+
+    const double sampleRate = processor.getSampleRate() > 0.0 ? processor.getSampleRate() : 44100.0;
+    updatePixelMap(width, sampleRate, frame.fftSize);
+
     const float minDb = -100.0f;  // Mínimo = -100 dB
     const float maxDb = 6.0f;     // Máximo = +6 dB (permite clipping visual)
 
-    for (int bin = 0; bin < fftSize / 2; ++bin) {
-        const float freq = bin * sampleRate / fftSize;
-        if (freq < 20.0f || freq > 20000.0f) continue;
+    // Combina os bins de cada pixel (máximo ou RMS) em magnitude linear
+    for (int x = 0; x < width; ++x) {
+        const auto& entry = pixelMap[static_cast<size_t>(x)];
+        const float* bins = magnitudes + entry.firstBin;
+        float level = 0.0f;
+
+        if (! entry.valid) {
+            level = 0.0f;
+        } else if (entry.numBins == 0) {
+            level = bins[0] + entry.fraction * (bins[1] - bins[0]);
+        } else if (binAggregation == BinAggregation::max) {
+            level = juce::FloatVectorOperations::findMaximum(bins, entry.numBins);
+        } else {
+            float sumOfSquares = 0.0f;
+            for (int i = 0; i < entry.numBins; ++i)
+                sumOfSquares += bins[i] * bins[i];
+            level = std::sqrt(sumOfSquares / entry.numBins);
+        }
+
+        pixelLevels[static_cast<size_t>(x)] = level;
+    }
 
-        // Converte magnitude para dB e aplica limites
-        float magnitudeDb = juce::Decibels::gainToDecibels(
-            juce::jmax(fftData[bin], std::pow(10.0f, minDb / 20.0f)) // Evita -Inf
-        );
-        magnitudeDb = juce::jlimit(minDb, maxDb, magnitudeDb);
+    // Conversão para dB e mapeamento para Y sobre o vetor de pixels
+    auto* levels = pixelLevels.data();
+    juce::FloatVectorOperations::clip(levels, levels, juce::Decibels::decibelsToGain(minDb), juce::Decibels::decibelsToGain(maxDb), width);
+    log10Levels(levels, width);
 
-        // Mapeia a frequência para a posição X e a magnitude para a posição Y
-        float x = bounds.getX() + std::log10(freq / 20.0f) * xScale;
-        float y = juce::jmap(magnitudeDb, minDb, maxDb, (float)bounds.getBottom(), (float)bounds.getY());
+    const float top = static_cast<float>(bounds.getY());
+    const float bottom = static_cast<float>(bounds.getBottom());
+    const float dbToY = (top - bottom) / (maxDb - minDb);
+    juce::FloatVectorOperations::multiply(levels, 20.0f * dbToY, width);
+    juce::FloatVectorOperations::add(levels, bottom - minDb * dbToY, width);
 
-        // Garante que o Path não saia dos limites
-        if (y < static_cast<float>(bounds.getY())) y = static_cast<float>(bounds.getY());
-        if (y > static_cast<float>(bounds.getBottom())) y = static_cast<float>(bounds.getBottom());
+    path.preallocateSpace(3 * (width + 2));
+    path.startNewSubPath(static_cast<float>(bounds.getX()), bottom);
 
-        path.lineTo(x, y);
+    float lastX = static_cast<float>(bounds.getX());
+
+    for (int x = 0; x < width; ++x) {
+        if (! pixelMap[static_cast<size_t>(x)].valid)
+            continue;
+
+        lastX = static_cast<float>(bounds.getX() + x);
+        path.lineTo(lastX, levels[x]);
     }
 
     // Feche o Path corretamente (opcional, para preenchimento)
-    path.lineTo(static_cast<float>(bounds.getRight()), static_cast<float>(bounds.getBottom()));
+    path.lineTo(lastX, bottom);
+}
+
+void SpectrumAnalyzer::resized() {
+   #if PARAMEQ_ENABLE_TELEMETRY
+    telemetryOverlay.setBounds(getLocalBounds().removeFromRight(340).removeFromTop(110).reduced(6));
+   #endif
+
+    gridLayer = {};
+    eqCurveLayer = {};
+    eqCurveLayerDirty = true;
+}
+
+// Imagem do tamanho do componente em pixels físicos
+juce::Image SpectrumAnalyzer::createLayerImage(juce::Image::PixelFormat format) const {
+    const int width = juce::jmax(1, juce::roundToInt(getWidth() * layerScale));
+    const int height = juce::jmax(1, juce::roundToInt(getHeight() * layerScale));
+    return juce::Image(format, width, height, true);
+}
+
+// Fundo, grades e rótulos
+void SpectrumAnalyzer::renderGridLayer() {
+    gridLayer = createLayerImage(juce::Image::RGB);
+    juce::Graphics g(gridLayer);
+    g.addTransform(juce::AffineTransform::scale(layerScale));
+
+    g.fillAll(juce::Colours::black);
+    drawDbGrid(g, getLocalBounds());        // horizontais
+    drawFrequencyGrid(g, getLocalBounds()); // verticais
+}
+
+// Curva de equalização sobre fundo transparente
+void SpectrumAnalyzer::renderEqCurveLayer() {
+    if (eqCurveLayer.isNull())
+        eqCurveLayer = createLayerImage(juce::Image::ARGB);
+    else
+        eqCurveLayer.clear(eqCurveLayer.getBounds());
+
+    juce::Graphics g(eqCurveLayer);
+    g.addTransform(juce::AffineTransform::scale(layerScale));
+    createEQCurvePlot(g, getLocalBounds());
+
+    eqCurveLayerDirty = false;
 }
 
 // Cria o gráfico da curva de equalização
@@ -165,11 +279,42 @@ void SpectrumAnalyzer::createEQCurvePlot(juce::Graphics& g, const juce::Rectangl
         return juce::jmap(db, minDb, maxDb, height, 0.0f);
     };
     
-    // Obtém os dados da curva do Cache
-    const auto& eqCurve = processor.cachedEqCurve;
-    
-    if (eqCurve.empty() || eqCurve.size() < bounds.getWidth())
-    return;
+    // Snapshot imutável publicado pela thread da curva
+    if (eqCurve == nullptr || eqCurve->total.size() < 2 || bounds.getWidth() < 2)
+        return;
+
+    // A curva pode ter sido calculada para outra largura (outro editor ou
+    // um redimensionamento ainda não atendido); os pontos são reescalados
+    const auto& curve = eqCurve->total;
+    const float pointScale = static_cast<float>(curve.size() - 1) / static_cast<float>(bounds.getWidth() - 1);
+    const float zeroY = juce::jmap(0.0f, minDb, maxDb, height, 0.0f);
+
+    // Contribuição de cada banda, entre 0 dB e a curva da banda; bandas
+    // neutras não são desenhadas
+    for (size_t band = 0; band < eqCurve->bands.size(); ++band) {
+        const auto& bandCurve = eqCurve->bands[band];
+        if (bandCurve.size() != curve.size())
+            continue;
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax(bandCurve.data(), static_cast<int>(bandCurve.size()));
+        if (range.getStart() > -0.05f && range.getEnd() < 0.05f)
+            continue;
+
+        juce::Path bandPath;
+        bandPath.startNewSubPath(0.0f, zeroY);
+        for (int x = 0; x < bounds.getWidth(); ++x) {
+            const float db = juce::jlimit(minDb, maxDb, bandCurve[static_cast<size_t>(juce::roundToInt(x * pointScale))]);
+            bandPath.lineTo(static_cast<float>(x), juce::jmap(db, minDb, maxDb, height, 0.0f));
+        }
+        bandPath.lineTo(width, zeroY);
+        bandPath.closeSubPath();
+
+        const auto colour = juce::Colour::fromHSV(static_cast<float>(band) / static_cast<float>(eqCurve->bands.size()), 0.6f, 1.0f, 1.0f);
+        g.setColour(colour.withAlpha(0.15f));
+        g.fillPath(bandPath);
+        g.setColour(colour.withAlpha(0.5f));
+        g.strokePath(bandPath, juce::PathStrokeType(1.0f));
+    }
     
     // Cria o path da curva
     juce::Path eqPath;
@@ -178,7 +323,7 @@ void SpectrumAnalyzer::createEQCurvePlot(juce::Graphics& g, const juce::Rectangl
     bool previousValid = false;
     
     for (int x = 0; x < bounds.getWidth(); ++x) {
-        float magnitudeDb = eqCurve[x];
+        float magnitudeDb = curve[static_cast<size_t>(juce::roundToInt(x * pointScale))];
         float y = dbToY(magnitudeDb, currentValid);
         
         if (currentValid) {
@@ -203,22 +348,217 @@ void SpectrumAnalyzer::createEQCurvePlot(juce::Graphics& g, const juce::Rectangl
     g.strokePath(eqPath, juce::PathStrokeType(2.0f));
 }
 
-// Callback do timer de atualização
-void SpectrumAnalyzer::timerCallback()
+// Aviso de quadro do timer compartilhado do serviço de análise
+void SpectrumAnalyzer::analysisFrameTick()
 {
-    if (processor.eqCurveNeedsUpdate)
-    {
-        processor.updateCachedEqCurve(getWidth(), static_cast<float>(processor.getSampleRate()));
+    // Editores fechados, minimizados ou em abas escondidas não custam nada
+    setAnalysisActive(isShowing());
+
+    if (! analysisActive)
+        return;
+
+    analysisWorker.setSampleRate(processor.getSampleRate());
+
+   #if PARAMEQ_ENABLE_TELEMETRY
+    if (telemetryOverlay.isVisible() && --ticksUntilTelemetryUpdate <= 0) {
+        telemetryOverlay.update(processor.getTelemetry());
+        ticksUntilTelemetryUpdate = AnalysisService::frameRateHz / 4;
     }
+   #endif
+
+    auto& curveWorker = processor.getEqCurveWorker();
+    curveWorker.setNumPoints(getWidth());
 
-    if (nextFFTBlockReady.exchange(false))
+    // Só troca o ponteiro; a curva já foi calculada em segundo plano
+    bool needsRepaint = false;
+    auto latestCurve = curveWorker.getLatestCurve();
+
+    if (latestCurve != eqCurve)
     {
-        juce::MessageManager::callAsync([this]() {
-            repaint();
+        eqCurve = std::move(latestCurve);
+        eqCurveLayerDirty = true;
+        needsRepaint = true;
+    }
+
+    if (analysisWorker.acquireLatestFrame())
+        needsRepaint = true;
+
+    if (needsRepaint)
+        repaint();
+}
+
+
+// Liga ou desliga a captura na thread de áudio, a análise nas threads do
+// serviço e a thread da curva
+void SpectrumAnalyzer::setAnalysisActive(bool shouldBeActive)
+{
+    if (shouldBeActive == analysisActive)
+        return;
+
+    analysisActive = shouldBeActive;
+    processor.setAnalyzerActive(shouldBeActive);
+    analysisWorker.setEnabled(shouldBeActive);
+
+    if (shouldBeActive)
+        processor.getEqCurveWorker().addClient();
+    else
+        processor.getEqCurveWorker().removeClient();
+}
+
+// Botão direito abre as opções do analisador
+void SpectrumAnalyzer::mouseDown(const juce::MouseEvent& event) {
+    if (event.mods.isPopupMenu())
+        showAnalyzerMenu();
+}
+
+// Menu com tamanho da FFT, sobreposição, média e pico
+void SpectrumAnalyzer::showAnalyzerMenu() {
+    const auto current = analysisWorker.getSettings();
+
+    juce::PopupMenu sizeMenu, overlapMenu, averagingMenu;
+
+    for (int order = SpectrumAnalysisWorker::minFftOrder; order <= SpectrumAnalysisWorker::maxFftOrder; ++order)
+        sizeMenu.addItem(juce::String(1 << order), true, current.fftOrder == order, [this, order] {
+            auto settings = analysisWorker.getSettings();
+            settings.fftOrder = order;
+            analysisWorker.setSettings(settings);
+        });
+
+    for (int overlap : { 1, 2, 4, 8 })
+        overlapMenu.addItem(juce::String(overlap) + "x", true, current.overlap == overlap, [this, overlap] {
+            auto settings = analysisWorker.getSettings();
+            settings.overlap = overlap;
+            analysisWorker.setSettings(settings);
+        });
+
+    const std::pair<const char*, float> averagingOptions[] = {
+        { "Off", 0.0f }, { "Fast", 0.05f }, { "Medium", 0.1f }, { "Slow", 0.4f }
+    };
+
+    for (const auto& [name, seconds] : averagingOptions) {
+        const float time = seconds;
+        averagingMenu.addItem(name, true, current.averagingSeconds == time, [this, time] {
+            auto settings = analysisWorker.getSettings();
+            settings.averagingSeconds = time;
+            analysisWorker.setSettings(settings);
         });
     }
+
+    juce::PopupMenu menu;
+    menu.addSubMenu("FFT Size", sizeMenu);
+    menu.addSubMenu("Overlap", overlapMenu);
+    menu.addSubMenu("Averaging", averagingMenu);
+    menu.addItem("Show Input", true, current.showInput, [this] {
+        auto settings = analysisWorker.getSettings();
+        settings.showInput = ! settings.showInput;
+        analysisWorker.setSettings(settings);
+    });
+    menu.addItem("Peak Hold", true, current.peakHold, [this] {
+        auto settings = analysisWorker.getSettings();
+        settings.peakHold = ! settings.peakHold;
+        analysisWorker.setSettings(settings);
+    });
+
+    // Combinação dos bins de cada pixel; só afeta o desenho
+    juce::PopupMenu aggregationMenu;
+    aggregationMenu.addItem("Max", true, binAggregation == BinAggregation::max, [this] {
+        binAggregation = BinAggregation::max;
+        repaint();
+    });
+    aggregationMenu.addItem("RMS", true, binAggregation == BinAggregation::rms, [this] {
+        binAggregation = BinAggregation::rms;
+        repaint();
+    });
+    menu.addSubMenu("Bin Aggregation", aggregationMenu);
+
+    addSnapshotMenuItems(menu);
+
+   #if PARAMEQ_ENABLE_TELEMETRY
+    addTelemetryMenuItems(menu);
+   #endif
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
 }
 
+// Guardar e chamar os snapshots; navegar, salvar e abrir o banco de presets
+void SpectrumAnalyzer::addSnapshotMenuItems(juce::PopupMenu& menu) {
+    juce::PopupMenu snapshotMenu, presetMenu;
+    const int currentSlot = processor.getCurrentSnapshot();
+
+    for (int slot = 0; slot < ParamEqAudioProcessor::NUM_SNAPSHOT_SLOTS; ++slot)
+        snapshotMenu.addItem("Recall " + juce::String::charToString(static_cast<juce::juce_wchar>('A' + slot)),
+                             processor.hasSnapshot(slot), currentSlot == slot, [this, slot] {
+            processor.recallSnapshot(slot);
+        });
+
+    snapshotMenu.addSeparator();
+
+    for (int slot = 0; slot < ParamEqAudioProcessor::NUM_SNAPSHOT_SLOTS; ++slot)
+        snapshotMenu.addItem("Store " + juce::String::charToString(static_cast<juce::juce_wchar>('A' + slot)), [this, slot] {
+            processor.storeSnapshot(slot);
+        });
+
+    const int numPresets = processor.getPresetBank().getNumPresets();
+    const int currentProgram = processor.getCurrentProgram();
+
+    presetMenu.addItem("Previous Preset", numPresets > 0, false, [this, numPresets, currentProgram] {
+        processor.setCurrentProgram((currentProgram + numPresets - 1) % numPresets);
+    });
+    presetMenu.addItem("Next Preset", numPresets > 0, false, [this, numPresets, currentProgram] {
+        processor.setCurrentProgram((currentProgram + 1) % numPresets);
+    });
+    presetMenu.addItem("Save as Preset", [this, numPresets] {
+        processor.addPresetToBank("Preset " + juce::String(numPresets + 1));
+    });
+    presetMenu.addItem("Load Preset Bank...", [this] {
+        presetBankFileChooser = std::make_unique<juce::FileChooser>(
+            "Load preset bank", ParamEqAudioProcessor::getDefaultPresetBankFile(), "*.peqbank");
+
+        presetBankFileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                           [this](const juce::FileChooser& chooser) {
+            const auto file = chooser.getResult();
+            if (file != juce::File())
+                processor.loadPresetBank(file);
+        });
+    });
+
+    menu.addSeparator();
+    menu.addSubMenu("Snapshots", snapshotMenu);
+    menu.addSubMenu(numPresets > 0 ? "Presets (" + processor.getProgramName(currentProgram) + ")" : juce::String("Presets"),
+                    presetMenu);
+}
+
+#if PARAMEQ_ENABLE_TELEMETRY
+// Overlay, reset e, no aplicativo standalone, gravação em JSON
+void SpectrumAnalyzer::addTelemetryMenuItems(juce::PopupMenu& menu) {
+    menu.addSeparator();
+    menu.addItem("Show Telemetry", true, telemetryOverlay.isVisible(), [this] {
+        telemetryOverlay.setVisible(! telemetryOverlay.isVisible());
+        ticksUntilTelemetryUpdate = 0;
+    });
+    menu.addItem("Reset Telemetry", [this] {
+        processor.getTelemetry().reset();
+        ticksUntilTelemetryUpdate = 0;
+    });
+
+    if (processor.wrapperType == juce::AudioProcessor::wrapperType_Standalone) {
+        menu.addItem("Save Telemetry...", [this] {
+            telemetryFileChooser = std::make_unique<juce::FileChooser>(
+                "Save telemetry",
+                juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("ParamEqTelemetry.json"),
+                "*.json");
+
+            telemetryFileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                                                  | juce::FileBrowserComponent::warnAboutOverwriting,
+                                              [this](const juce::FileChooser& chooser) {
+                const auto file = chooser.getResult();
+                if (file != juce::File())
+                    processor.getTelemetry().writeToFile(file);
+            });
+        });
+    }
+}
+#endif
 
 // Callback quando um parâmetro é alterado
 void SpectrumAnalyzer::parameterValueChanged(int, float) {
@@ -19,12 +19,16 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PluginProcessor.h"
+#include "AnalysisService.h"
+#include "SpectrumAnalysisWorker.h"
+#include "EqCurveWorker.h"
+#include "TelemetryOverlay.h"
 
 // Declaração antecipada do processador de áudio para evitar dependências circulares.
 class ParamEqAudioProcessor;
 
 class SpectrumAnalyzer : public juce::Component,
-                         public juce::Timer,
+                         public AnalysisService::Listener,
                          public juce::AudioProcessorParameter::Listener
 {
 public:
@@ -32,19 +36,25 @@ public:
     ~SpectrumAnalyzer() override;
 
     void paint(juce::Graphics&) override;
-    void timerCallback() override;
+    void resized() override;
+    void mouseDown(const juce::MouseEvent&) override;
+    void analysisFrameTick() override;
     void parameterValueChanged(int, float) override;
     void parameterGestureChanged(int, bool) override {};
 
-    // Métodos para alimentar o analisador
-    void pushBuffer(const juce::AudioBuffer<float>& buffer);
-    void pushSample(float sample);
-
 private:
-    void processFFT();
-    void createFrequencyPlotPath(juce::Path& path, const juce::Rectangle<int> bounds);
+    void createFrequencyPlotPath(juce::Path& path, const juce::Rectangle<int> bounds, const float* magnitudes);
+    void updatePixelMap(int width, double sampleRate, int fftSize);
+    void showAnalyzerMenu();
+    void setAnalysisActive(bool shouldBeActive);
     void createEQCurvePlot(juce::Graphics& g, const juce::Rectangle<int> bounds);
 
+    // Camadas em cache: grade (muda só com tamanho ou escala) e curva de
+    // equalização (muda só quando chega um snapshot novo)
+    void renderGridLayer();
+    void renderEqCurveLayer();
+    juce::Image createLayerImage(juce::Image::PixelFormat format) const;
+
     // Desenho de grades de referência
     void drawDbGrid(juce::Graphics& g, const juce::Rectangle<int> bounds);
     void drawFrequencyGrid(juce::Graphics& g, const juce::Rectangle<int> bounds);
@@ -53,18 +63,57 @@ private:
     ParamEqAudioProcessor& processor;
 
     // Configurações de visualização
-    juce::Path spectrumPath;
-    juce::CriticalSection pathLock;
-    juce::CriticalSection bufferLock;
-    
-    // Configurações FFT
-    static constexpr int fftOrder = 12;
-    static constexpr int fftSize = 1 << fftOrder;
-    juce::dsp::FFT forwardFFT;
-    
-    // Buffers
-    juce::AudioBuffer<float> fftBuffer;
-    juce::AudioBuffer<float> fifoBuffer;
-    int fifoIndex = 0;
-    std::atomic<bool> nextFFTBlockReady{false};
+    juce::Path spectrumPath, inputPath, peakPath; // reaproveitados a cada quadro
+
+    // Como os bins de cada pixel são combinados
+    enum class BinAggregation { max, rms };
+    BinAggregation binAggregation = BinAggregation::max;
+
+    // Bins que caem em cada pixel; pixels mais estreitos que um bin
+    // interpolam entre os dois bins vizinhos
+    struct PixelBins
+    {
+        int firstBin = 0;
+        int numBins = 0;        // 0 = interpola entre firstBin e firstBin + 1
+        float fraction = 0.0f;
+        bool valid = false;     // falso acima de Nyquist
+    };
+
+    // Tabela refeita só quando largura, taxa ou tamanho da FFT mudam
+    std::vector<PixelBins> pixelMap;
+    std::vector<float> pixelLevels; // uma posição por pixel
+    int mappedWidth = 0;
+    int mappedFftSize = 0;
+    double mappedSampleRate = 0.0;
+
+    // Serviço do processo: threads de FFT, planos e o timer de quadros.
+    // Declarado antes da análise, que se registra nele
+    juce::SharedResourcePointer<AnalysisService> analysisService;
+
+    // FFT executada fora da thread de áudio e da thread de mensagens;
+    // tamanho, sobreposição, média e pico são escolhidos no menu do botão direito
+    SpectrumAnalysisWorker analysisWorker;
+
+    // Captura, análise e curva só rodam enquanto o componente está visível
+    bool analysisActive = false;
+
+    // Snapshots A/B/C/D e banco de presets, no mesmo menu
+    void addSnapshotMenuItems(juce::PopupMenu& menu);
+    std::unique_ptr<juce::FileChooser> presetBankFileChooser;
+
+   #if PARAMEQ_ENABLE_TELEMETRY
+    // Overlay ligado pelo menu; atualizado algumas vezes por segundo
+    void addTelemetryMenuItems(juce::PopupMenu& menu);
+    TelemetryOverlay telemetryOverlay;
+    int ticksUntilTelemetryUpdate = 0;
+    std::unique_ptr<juce::FileChooser> telemetryFileChooser;
+   #endif
+
+    // Snapshot da curva de equalização em uso; trocado pelo timer
+    EqCurveWorker::Snapshot eqCurve;
+
+    // Imagens das camadas, na resolução física da tela
+    juce::Image gridLayer, eqCurveLayer;
+    float layerScale = 0.0f;
+    bool eqCurveLayerDirty = true;
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "TelemetryOverlay.h"
+
+#if PARAMEQ_ENABLE_TELEMETRY
+
+TelemetryOverlay::TelemetryOverlay()
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+void TelemetryOverlay::update(const PerformanceTelemetry& telemetry)
+{
+    const auto s = telemetry.getSnapshot();
+    const auto blocks = juce::jmax<juce::uint64>(1, s.blocks);
+    const auto log2 = TelemetryHistogram::Scale::log2;
+    const auto linear = TelemetryHistogram::Scale::linear;
+
+    juce::String updates;
+    for (auto bandUpdates : s.coefficientUpdates)
+        updates << juce::String((juce::int64) bandUpdates) << " ";
+
+    lines.clearQuick();
+    lines.add("Block: " + juce::String(s.blockNanoseconds.getMean() / 1000.0, 1) + " us avg, "
+              + juce::String(s.blockNanoseconds.getPercentile(0.99, log2, 1.0) / 1000.0, 1) + " us p99, "
+              + juce::String(s.blockNanoseconds.maximum / 1000.0, 1) + " us max");
+    lines.add("Per sample: " + juce::String(s.nanosecondsPerSample.getMean(), 1) + " ns avg");
+    lines.add("Load: " + juce::String(s.blockLoadPercent.getMean(), 1) + "% avg, "
+              + juce::String(s.blockLoadPercent.getPercentile(0.99, linear, 10.0), 0) + "% p99, overruns "
+              + juce::String((juce::int64) s.deadlineOverruns) + "/" + juce::String((juce::int64) s.blocks));
+    lines.add("Bands/block: " + juce::String((double) s.processedBands / (double) blocks, 1) + " processed, "
+              + juce::String((double) s.skippedBands / (double) blocks, 1) + " skipped");
+    lines.add("Coeff updates: " + updates.trimEnd());
+    lines.add("Analyzer: " + juce::String((juce::int64) s.analyzerPushes) + " pushes, "
+              + juce::String((juce::int64) s.analyzerDroppedSamples) + " samples dropped");
+
+    repaint();
+}
+
+void TelemetryOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.7f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    g.setColour(juce::Colours::white.withAlpha(0.9f));
+    g.setFont(juce::FontOptions(12.0f));
+
+    auto area = getLocalBounds().reduced(6, 4);
+    const int lineHeight = area.getHeight() / juce::jmax(1, lines.size());
+
+    for (const auto& line : lines)
+        g.drawText(line, area.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+}
+
+#endif
@@ -0,0 +1,41 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "PerformanceTelemetry.h"
+
+#if PARAMEQ_ENABLE_TELEMETRY
+
+//==============================================================================
+/** Painel semitransparente com o resumo da telemetria de processBlock,
+    desenhado sobre o analisador. Não recebe cliques.
+*/
+class TelemetryOverlay : public juce::Component
+{
+public:
+    TelemetryOverlay();
+
+    // Chamado pela thread de mensagens com a telemetria do processador
+    void update(const PerformanceTelemetry& telemetry);
+
+    void paint(juce::Graphics&) override;
+
+private:
+    juce::StringArray lines;
+};
+
+#endif
@@ -0,0 +1,69 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/** Buffer triplo para publicar sempre o valor mais recente entre duas threads.
+
+    O escritor preenche getWriteBuffer() e chama publish(); o leitor chama
+    acquireLatest() e lê getReadBuffer(). Nenhum dos lados espera pelo outro:
+    a troca de buffers é feita com uma única operação atômica, e valores
+    intermediários que o leitor não chegou a ver são descartados.
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Inicializa os três buffers; chamar antes de as threads começarem a usá-lo
+    void fill(const T& value)
+    {
+        for (auto& buffer : buffers)
+            buffer = value;
+    }
+
+    //=============================== Escritor ================================
+    T& getWriteBuffer() noexcept { return buffers[(size_t) writeIndex]; }
+
+    void publish() noexcept
+    {
+        writeIndex = middle.exchange(writeIndex | newDataFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    //=============================== Leitor ==================================
+    // Retorna true se havia um valor novo, que passa a estar em getReadBuffer()
+    bool acquireLatest() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & newDataFlag) == 0)
+            return false;
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const noexcept { return buffers[(size_t) readIndex]; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newDataFlag = 4;
+
+    std::array<T, 3> buffers;
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> middle { 2 };
+};
@@ -0,0 +1,467 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+// Verifica que processBlock nunca aloca memória: precisão simples e dupla,
+// cada fator de sobreamostragem, a fase linear em cada tamanho de kernel,
+// bandas dinâmicas e trocas de snapshot e programa entre os blocos.
+// Registrado no CTest; o código de saída é 1 se alguma configuração alocar.
+
+#include <juce_events/juce_events.h>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "../Source/PluginProcessor.h"
+
+//==============================================================================
+// Contagem de alocações: operator new (também as versões alinhadas) e, com
+// a glibc, malloc, calloc, realloc, posix_memalign, aligned_alloc e
+// memalign são substituídos. A JUCE aloca HeapBlock e AudioBuffer com
+// std::malloc, então contar só o operator new não basta. A contagem vale
+// apenas enquanto uma ScopedAllocationCounter estiver ativa na thread atual
+#if defined(__GLIBC__)
+ #define PARAMEQ_HOOKS_MALLOC 1
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+}
+#else
+ #define PARAMEQ_HOOKS_MALLOC 0
+#endif
+
+namespace
+{
+    std::atomic<juce::int64> allocationCount { 0 };
+    thread_local bool countingAllocations = false;
+
+    struct ScopedAllocationCounter
+    {
+        ScopedAllocationCounter()  { countingAllocations = true; }
+        ~ScopedAllocationCounter() { countingAllocations = false; }
+    };
+
+    void countAllocation() noexcept
+    {
+        if (countingAllocations)
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Alocações abaixo dos ganchos, para que o operator new não conte duas vezes
+    void* rawMalloc(std::size_t size) noexcept
+    {
+       #if PARAMEQ_HOOKS_MALLOC
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void* rawAlignedMalloc(std::size_t size, std::size_t alignment) noexcept
+    {
+       #if PARAMEQ_HOOKS_MALLOC
+        return __libc_memalign(alignment, size);
+       #elif defined(_WIN32)
+        return _aligned_malloc(size, alignment);
+       #else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, juce::jmax(alignment, sizeof(void*)), size) == 0 ? ptr : nullptr;
+       #endif
+    }
+
+    void rawAlignedFree(void* ptr) noexcept
+    {
+       #if defined(_WIN32)
+        _aligned_free(ptr);
+       #else
+        std::free(ptr);
+       #endif
+    }
+}
+
+#if PARAMEQ_HOOKS_MALLOC
+extern "C"
+{
+    void* malloc(size_t size) noexcept                          { countAllocation(); return __libc_malloc(size); }
+    void* calloc(size_t count, size_t size) noexcept            { countAllocation(); return __libc_calloc(count, size); }
+    void* realloc(void* ptr, size_t size) noexcept              { countAllocation(); return __libc_realloc(ptr, size); }
+    void* memalign(size_t alignment, size_t size) noexcept      { countAllocation(); return __libc_memalign(alignment, size); }
+    void* aligned_alloc(size_t alignment, size_t size) noexcept { countAllocation(); return __libc_memalign(alignment, size); }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        countAllocation();
+
+        if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+}
+#endif
+
+void* operator new (std::size_t size)
+{
+    countAllocation();
+
+    if (auto* ptr = rawMalloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    countAllocation();
+
+    if (auto* ptr = rawAlignedMalloc(size == 0 ? 1 : size, static_cast<std::size_t>(alignment)))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)                                    { return operator new (size); }
+void* operator new[] (std::size_t size, std::align_val_t alignment)        { return operator new (size, alignment); }
+void operator delete (void* ptr) noexcept                                   { std::free(ptr); }
+void operator delete[] (void* ptr) noexcept                                 { std::free(ptr); }
+void operator delete (void* ptr, std::size_t) noexcept                      { std::free(ptr); }
+void operator delete[] (void* ptr, std::size_t) noexcept                    { std::free(ptr); }
+void operator delete (void* ptr, std::align_val_t) noexcept                 { rawAlignedFree(ptr); }
+void operator delete[] (void* ptr, std::align_val_t) noexcept               { rawAlignedFree(ptr); }
+void operator delete (void* ptr, std::size_t, std::align_val_t) noexcept    { rawAlignedFree(ptr); }
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept  { rawAlignedFree(ptr); }
+
+namespace
+{
+    //==============================================================================
+    struct TestConfig
+    {
+        int numChannels = 2;
+        int blockSize = 512;
+        FilterType type = PEAK;
+        bool doublePrecision = false;
+        int oversamplingIndex = 0; // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+        int linearPhaseLengthIndex = -1; // -1 = cascata IIR
+        bool dynamic = false;
+        bool switchPresets = false; // recallSnapshot e setCurrentProgram entre os blocos
+    };
+
+    constexpr int numBlocksPerConfig = 32;
+    constexpr int numBankPresets = 16;
+
+    const std::array<FilterType, 5> allFilterTypes { PEAK, LOW_SHELF, HIGH_SHELF, LOW_PASS, HIGH_PASS };
+
+    juce::String describe(const TestConfig& config)
+    {
+        juce::String text;
+        text << ParamEqAudioProcessor::getFilterTypeName(config.type)
+             << ", " << config.numChannels << " canais, bloco " << config.blockSize
+             << (config.doublePrecision ? ", double" : ", float")
+             << ", " << (1 << config.oversamplingIndex) << "x";
+
+        if (config.linearPhaseLengthIndex >= 0)
+            text << ", fase linear " << LinearPhaseEngine::getKernelLength(config.linearPhaseLengthIndex);
+        if (config.dynamic)
+            text << ", dinâmico";
+        if (config.switchPresets)
+            text << ", trocas de snapshot e programa";
+
+        return text;
+    }
+
+    void setParameter(ParamEqAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.parameters.getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    void setBandParameter(ParamEqAudioProcessor& processor, BandParameter parameter, int band, float value)
+    {
+        setParameter(processor, ParamEqAudioProcessor::getBandParameterID(parameter, band), value);
+    }
+
+    // Todas as bandas com o tipo pedido, frequências espalhadas pelo
+    // espectro e ganhos alternados
+    void configureBands(ParamEqAudioProcessor& processor, FilterType type, float gainDb)
+    {
+        for (int band = 0; band < ParamEqAudioProcessor::NUM_BANDS; ++band)
+        {
+            const float freq = juce::mapToLog10((band + 0.5f) / ParamEqAudioProcessor::NUM_BANDS, 40.0f, 16000.0f);
+
+            setBandParameter(processor, BAND_TYPE, band, static_cast<float>(type));
+            setBandParameter(processor, BAND_FREQ, band, freq);
+            setBandParameter(processor, BAND_GAIN, band, band % 2 == 0 ? gainDb : -gainDb);
+            setBandParameter(processor, BAND_Q, band, 0.9f);
+        }
+    }
+
+    std::unique_ptr<ParamEqAudioProcessor> createProcessor(const TestConfig& config, const juce::File& bankFile)
+    {
+        auto processor = std::make_unique<ParamEqAudioProcessor>();
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(config.numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(config.numChannels));
+        processor->setBusesLayout(layout);
+        processor->setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                 : juce::AudioProcessor::singlePrecision);
+
+        configureBands(*processor, config.type, 6.0f);
+
+        if (config.dynamic)
+        {
+            // Limiar baixo: os detectores sempre pedem redução de ganho
+            for (int band = 0; band < ParamEqAudioProcessor::NUM_BANDS; ++band)
+            {
+                setBandParameter(*processor, BAND_DYNAMIC, band, 1.0f);
+                setBandParameter(*processor, BAND_THRESHOLD, band, -50.0f);
+                setBandParameter(*processor, BAND_RATIO, band, 4.0f);
+                setBandParameter(*processor, BAND_ATTACK, band, 1.0f);
+            }
+        }
+
+        setParameter(*processor, ParamEqAudioProcessor::OVERSAMPLING_ID, static_cast<float>(config.oversamplingIndex));
+
+        if (config.linearPhaseLengthIndex >= 0)
+        {
+            setParameter(*processor, ParamEqAudioProcessor::PHASE_MODE_ID, 1.0f);
+            setParameter(*processor, ParamEqAudioProcessor::LINEAR_PHASE_LENGTH_ID, static_cast<float>(config.linearPhaseLengthIndex));
+        }
+
+        processor->setRateAndBufferSizeDetails(48000.0, config.blockSize);
+        processor->prepareToPlay(48000.0, config.blockSize);
+        processor->setAnalyzerActive(true);
+
+        if (config.switchPresets)
+        {
+            processor->loadPresetBank(bankFile);
+
+            // Snapshots diferentes entre si, projetados já na taxa preparada
+            for (int slot = 0; slot < ParamEqAudioProcessor::NUM_SNAPSHOT_SLOTS; ++slot)
+            {
+                configureBands(*processor, allFilterTypes[(size_t) slot], 3.0f * (slot + 1));
+                processor->storeSnapshot(slot);
+            }
+        }
+
+        return processor;
+    }
+
+    template <typename SampleType>
+    void fillWithNoise(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, static_cast<SampleType>(random.nextFloat() * 0.5f - 0.25f));
+    }
+
+    // Processa alguns blocos com automação (e trocas, se pedidas) entre eles,
+    // como o host faria, contando só as alocações dentro de processBlock
+    template <typename SampleType>
+    juce::int64 countAllocations(const TestConfig& config, const juce::File& bankFile)
+    {
+        auto processor = createProcessor(config, bankFile);
+
+        juce::AudioBuffer<SampleType> buffer(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1234); // semente fixa: execuções repetíveis
+        juce::int64 allocations = 0;
+
+        for (int i = 0; i < numBlocksPerConfig; ++i)
+        {
+            setBandParameter(*processor, BAND_GAIN, i % ParamEqAudioProcessor::NUM_BANDS, static_cast<float>(i % 12));
+
+            if (config.switchPresets)
+            {
+                if (i % 4 == 1)
+                    processor->recallSnapshot(i % ParamEqAudioProcessor::NUM_SNAPSHOT_SLOTS);
+                else if (i % 4 == 3)
+                    processor->setCurrentProgram(i % juce::jmax(1, processor->getNumPrograms()));
+            }
+
+            fillWithNoise(buffer, random);
+
+            const auto before = allocationCount.load();
+            {
+                const ScopedAllocationCounter counter;
+                processor->processBlock(buffer, midi);
+            }
+            allocations += allocationCount.load() - before;
+        }
+
+        return allocations;
+    }
+
+    std::vector<TestConfig> makeTestConfigs()
+    {
+        std::vector<TestConfig> configs;
+
+        for (bool doublePrecision : { false, true })
+        {
+            // Tipos de filtro, layouts e tamanhos de bloco em 1x
+            for (auto type : allFilterTypes)
+                for (int numChannels : { 1, 2, 16 })
+                    for (int blockSize : { 16, 512, 8192 })
+                        for (bool dynamic : { false, true })
+                        {
+                            TestConfig config;
+                            config.numChannels = numChannels;
+                            config.blockSize = blockSize;
+                            config.type = type;
+                            config.doublePrecision = doublePrecision;
+                            config.dynamic = dynamic;
+                            configs.push_back(config);
+                        }
+
+            // Cada fator de sobreamostragem
+            for (int oversamplingIndex = 1; oversamplingIndex < ParamEqAudioProcessor::NUM_OVERSAMPLING_FACTORS; ++oversamplingIndex)
+                for (int numChannels : { 1, 16 })
+                    for (int blockSize : { 16, 8192 })
+                        for (bool dynamic : { false, true })
+                        {
+                            TestConfig config;
+                            config.numChannels = numChannels;
+                            config.blockSize = blockSize;
+                            config.doublePrecision = doublePrecision;
+                            config.oversamplingIndex = oversamplingIndex;
+                            config.dynamic = dynamic;
+                            configs.push_back(config);
+                        }
+
+            // Fase linear em cada tamanho de kernel; a automação entre os
+            // blocos faz a thread de construção trocar os kernels
+            for (int lengthIndex = 0; lengthIndex < LinearPhaseEngine::numKernelLengths; ++lengthIndex)
+                for (int numChannels : { 1, 2, 16 })
+                    for (int blockSize : { 16, 8192 })
+                    {
+                        TestConfig config;
+                        config.numChannels = numChannels;
+                        config.blockSize = blockSize;
+                        config.doublePrecision = doublePrecision;
+                        config.linearPhaseLengthIndex = lengthIndex;
+                        configs.push_back(config);
+                    }
+
+            // Snapshots e programas trocados entre os blocos, em cada fator
+            // e também em fase linear
+            for (int oversamplingIndex = 0; oversamplingIndex < ParamEqAudioProcessor::NUM_OVERSAMPLING_FACTORS; ++oversamplingIndex)
+                for (int lengthIndex : { -1, 1 })
+                    for (bool dynamic : { false, true })
+                    {
+                        TestConfig config;
+                        config.doublePrecision = doublePrecision;
+                        config.oversamplingIndex = oversamplingIndex;
+                        config.linearPhaseLengthIndex = lengthIndex;
+                        config.dynamic = dynamic;
+                        config.switchPresets = true;
+                        configs.push_back(config);
+                    }
+        }
+
+        return configs;
+    }
+
+    // O teste só vale se enxergar alocações: um AudioBuffer (std::malloc)
+    // e um std::vector (operator new) criados com o contador ativo precisam
+    // ser detectados
+    bool detectsAllocations()
+    {
+        static volatile float sink = 0.0f;
+
+        const auto before = allocationCount.load();
+        {
+            const ScopedAllocationCounter counter;
+            juce::AudioBuffer<float> buffer(2, 512);
+            buffer.setSample(1, 511, 1.0f);
+            sink = sink + buffer.getSample(1, 511);
+        }
+        const bool detectedMalloc = allocationCount.load() > before;
+
+        const auto beforeNew = allocationCount.load();
+        {
+            const ScopedAllocationCounter counter;
+            std::vector<float> values(512, 1.0f);
+            sink = sink + values.back();
+        }
+        const bool detectedNew = allocationCount.load() > beforeNew;
+
+        return detectedNew && (detectedMalloc || ! PARAMEQ_HOOKS_MALLOC);
+    }
+
+    // Banco temporário para setCurrentProgram, com presets variados
+    void writeTestBank(const juce::File& file)
+    {
+        ParamEqAudioProcessor processor;
+        juce::StringArray names;
+        std::vector<float> values;
+
+        for (int i = 0; i < numBankPresets; ++i)
+        {
+            configureBands(processor, allFilterTypes[(size_t) (i % static_cast<int>(allFilterTypes.size()))], static_cast<float>(i % 12));
+
+            const auto presetValues = processor.getParameterValues();
+            values.insert(values.end(), presetValues.begin(), presetValues.end());
+            names.add("Preset " + juce::String(i + 1));
+        }
+
+        PresetBank::write(file, processor.getStateParameterIDs(), names, values.data());
+    }
+}
+
+//==============================================================================
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    if (! detectsAllocations())
+    {
+        std::cout << "FALHOU: a contagem não detectou uma alocação proposital\n";
+        return 1;
+    }
+
+   #if ! PARAMEQ_HOOKS_MALLOC
+    std::cout << "Aviso: malloc não é interceptado nesta plataforma; só o operator new é contado\n";
+   #endif
+
+    juce::TemporaryFile bankFile(".peqbank");
+    writeTestBank(bankFile.getFile());
+
+    const auto configs = makeTestConfigs();
+    juce::int64 totalAllocations = 0;
+    int numFailures = 0;
+
+    for (const auto& config : configs)
+    {
+        const auto allocations = config.doublePrecision ? countAllocations<double>(config, bankFile.getFile())
+                                                        : countAllocations<float>(config, bankFile.getFile());
+
+        if (allocations > 0)
+        {
+            std::cout << "FALHOU: " << describe(config) << ": " << allocations << " alocações\n";
+            totalAllocations += allocations;
+            ++numFailures;
+        }
+    }
+
+    std::cout << configs.size() << " configurações, " << numFailures << " com alocações ("
+              << totalAllocations << " no total)\n";
+
+    return numFailures == 0 ? 0 : 1;
+}
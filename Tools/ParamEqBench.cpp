@@ -0,0 +1,823 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+// Microbenchmarks do ParamEQ. Os resultados saem em JSON para que possam
+// ser comparados entre versões. A verificação de alocações fica no
+// ParamEqAllocationTest.
+
+#include <juce_events/juce_events.h>
+#include <cstdlib>
+#include <iostream>
+#include "../Source/PluginProcessor.h"
+
+namespace
+{
+    //==============================================================================
+    struct ProcessConfig
+    {
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        int blockSize = 512;
+        int activeBands = ParamEqAudioProcessor::NUM_BANDS;
+        FilterType type = PEAK;
+        bool doublePrecision = false;
+        int oversamplingIndex = 0; // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+        int linearPhaseLengthIndex = -1; // -1 = cascata IIR
+        DesignMethod designMethod = BILINEAR;
+        bool dynamic = false; // todas as bandas dinâmicas, com redução constante
+    };
+
+    struct Options
+    {
+        bool fullMatrix = false;
+        double secondsPerRun = 0.5;
+        int numRuns = 5;
+        juce::File outputFile;
+    };
+
+    const std::array<FilterType, 5> allFilterTypes { PEAK, LOW_SHELF, HIGH_SHELF, LOW_PASS, HIGH_PASS };
+
+    void setBandParameter(ParamEqAudioProcessor& processor, BandParameter parameter, int band, float value)
+    {
+        if (auto* param = processor.parameters.getParameter(ParamEqAudioProcessor::getBandParameterID(parameter, band)))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    // Configura as bandas: as primeiras activeBands com o tipo pedido e
+    // frequências espalhadas pelo espectro, as demais neutras
+    void configureBands(ParamEqAudioProcessor& processor, int activeBands, FilterType type)
+    {
+        for (int band = 0; band < ParamEqAudioProcessor::NUM_BANDS; ++band)
+        {
+            const bool active = band < activeBands;
+            const float freq = juce::mapToLog10((band + 0.5f) / ParamEqAudioProcessor::NUM_BANDS, 40.0f, 16000.0f);
+
+            setBandParameter(processor, BAND_TYPE, band, static_cast<float>(active ? type : PEAK));
+            setBandParameter(processor, BAND_FREQ, band, freq);
+            setBandParameter(processor, BAND_GAIN, band, active ? (band % 2 == 0 ? 6.0f : -6.0f) : 0.0f);
+            setBandParameter(processor, BAND_Q, band, 0.9f);
+        }
+    }
+
+    std::unique_ptr<ParamEqAudioProcessor> createProcessor(const ProcessConfig& config)
+    {
+        auto processor = std::make_unique<ParamEqAudioProcessor>();
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(config.numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(config.numChannels));
+        processor->setBusesLayout(layout);
+        processor->setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                 : juce::AudioProcessor::singlePrecision);
+
+        configureBands(*processor, config.activeBands, config.type);
+
+        if (config.dynamic)
+        {
+            // Limiar baixo: os detectores sempre pedem redução de ganho
+            for (int band = 0; band < ParamEqAudioProcessor::NUM_BANDS; ++band)
+            {
+                setBandParameter(*processor, BAND_DYNAMIC, band, 1.0f);
+                setBandParameter(*processor, BAND_THRESHOLD, band, -50.0f);
+                setBandParameter(*processor, BAND_RATIO, band, 4.0f);
+                setBandParameter(*processor, BAND_ATTACK, band, 1.0f);
+            }
+        }
+
+        if (auto* param = processor->parameters.getParameter(ParamEqAudioProcessor::OVERSAMPLING_ID))
+            param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(config.oversamplingIndex)));
+
+        if (auto* param = processor->parameters.getParameter(ParamEqAudioProcessor::DESIGN_METHOD_ID))
+            param->setValueNotifyingHost(config.designMethod == MATCHED ? 1.0f : 0.0f);
+
+        if (config.linearPhaseLengthIndex >= 0)
+        {
+            if (auto* param = processor->parameters.getParameter(ParamEqAudioProcessor::PHASE_MODE_ID))
+                param->setValueNotifyingHost(1.0f);
+            if (auto* param = processor->parameters.getParameter(ParamEqAudioProcessor::LINEAR_PHASE_LENGTH_ID))
+                param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(config.linearPhaseLengthIndex)));
+        }
+
+        processor->setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+        processor->prepareToPlay(config.sampleRate, config.blockSize);
+        return processor;
+    }
+
+    template <typename SampleType>
+    void fillWithNoise(juce::AudioBuffer<SampleType>& buffer)
+    {
+        juce::Random random(1234); // semente fixa: execuções repetíveis
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, static_cast<SampleType>(random.nextFloat() * 0.5f - 0.25f));
+    }
+
+    double ticksToNs(juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9;
+    }
+
+    double median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    //==============================================================================
+    // Mede processBlock em ns/amostra (por canal de tempo, não por canal de áudio).
+    // O buffer é restaurado a cada bloco; o custo dessa cópia é medido à parte
+    // e descontado.
+    template <typename SampleType>
+    std::vector<double> measureProcessBlock(const ProcessConfig& config, const Options& options)
+    {
+        auto processor = createProcessor(config);
+
+        juce::AudioBuffer<SampleType> source(config.numChannels, config.blockSize);
+        juce::AudioBuffer<SampleType> buffer(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+        fillWithNoise(source);
+
+        const int numBlocks = juce::jmax(64, static_cast<int>(config.sampleRate * options.secondsPerRun / config.blockSize));
+
+        auto restore = [&]
+        {
+            for (int ch = 0; ch < config.numChannels; ++ch)
+                buffer.copyFrom(ch, 0, source, ch, 0, config.blockSize);
+        };
+
+        // Aquecimento: consome as flags de coeficientes e estabiliza caches
+        for (int i = 0; i < 16; ++i)
+        {
+            restore();
+            processor->processBlock(buffer, midi);
+        }
+
+        std::vector<double> runs;
+
+        for (int run = 0; run < options.numRuns; ++run)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                restore();
+                processor->processBlock(buffer, midi);
+            }
+            const auto middle = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < numBlocks; ++i)
+                restore();
+            const auto end = juce::Time::getHighResolutionTicks();
+
+            const double ns = ticksToNs((middle - start) - (end - middle));
+            runs.push_back(juce::jmax(0.0, ns) / (static_cast<double>(numBlocks) * config.blockSize));
+        }
+
+        return runs;
+    }
+
+    juce::var benchProcessBlock(const ProcessConfig& config, const Options& options)
+    {
+        const auto runs = config.doublePrecision ? measureProcessBlock<double>(config, options)
+                                                 : measureProcessBlock<float>(config, options);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("sampleRate", config.sampleRate);
+        result->setProperty("channels", config.numChannels);
+        result->setProperty("blockSize", config.blockSize);
+        result->setProperty("activeBands", config.activeBands);
+        result->setProperty("filterType", ParamEqAudioProcessor::getFilterTypeName(config.type));
+        result->setProperty("precision", config.doublePrecision ? "double" : "float");
+        result->setProperty("oversampling", 1 << config.oversamplingIndex);
+        result->setProperty("linearPhaseLength", config.linearPhaseLengthIndex < 0
+                                                     ? 0 : LinearPhaseEngine::getKernelLength(config.linearPhaseLengthIndex));
+        result->setProperty("design", config.designMethod == MATCHED ? "matched" : "bilinear");
+        result->setProperty("dynamic", config.dynamic);
+        result->setProperty("nsPerSample", median(runs));
+        result->setProperty("nsPerSampleMin", *std::min_element(runs.begin(), runs.end()));
+        return juce::var(result);
+    }
+
+    juce::var runProcessBlockSuite(const Options& options)
+    {
+        const std::vector<double> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+        const std::vector<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+        const std::vector<int> channelCounts { 1, 2, 6, 12, 16 };
+        const std::vector<int> bandCounts { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+
+        juce::Array<juce::var> results;
+        const ProcessConfig reference;
+
+        if (options.fullMatrix)
+        {
+            for (auto sampleRate : sampleRates)
+                for (auto numChannels : channelCounts)
+                    for (auto blockSize : blockSizes)
+                        for (auto activeBands : bandCounts)
+                            for (auto type : allFilterTypes)
+                                results.add(benchProcessBlock({ sampleRate, numChannels, blockSize, activeBands, type }, options));
+        }
+        else
+        {
+            // Varia uma dimensão por vez em torno da configuração de referência
+            for (auto blockSize : blockSizes)
+                for (auto numChannels : channelCounts)
+                    results.add(benchProcessBlock({ reference.sampleRate, numChannels, blockSize, reference.activeBands, reference.type }, options));
+
+            for (auto activeBands : bandCounts)
+                results.add(benchProcessBlock({ reference.sampleRate, reference.numChannels, reference.blockSize, activeBands, reference.type }, options));
+
+            for (auto type : allFilterTypes)
+                results.add(benchProcessBlock({ reference.sampleRate, reference.numChannels, reference.blockSize, reference.activeBands, type }, options));
+
+            for (auto sampleRate : sampleRates)
+                results.add(benchProcessBlock({ sampleRate, reference.numChannels, reference.blockSize, reference.activeBands, reference.type }, options));
+        }
+
+        return results;
+    }
+
+    // Mesmas configurações em float e em double, lado a lado
+    juce::var runPrecisionSuite(const Options& options)
+    {
+        juce::Array<juce::var> results;
+
+        for (int numChannels : { 2, 16 })
+        {
+            for (int blockSize : { 64, 512, 4096 })
+            {
+                for (bool doublePrecision : { false, true })
+                {
+                    ProcessConfig config;
+                    config.numChannels = numChannels;
+                    config.blockSize = blockSize;
+                    config.doublePrecision = doublePrecision;
+                    results.add(benchProcessBlock(config, options));
+                }
+            }
+        }
+
+        return results;
+    }
+
+    // Custo de cada fator de sobreamostragem, incluindo os filtros de meia banda
+    juce::var runOversamplingSuite(const Options& options)
+    {
+        juce::Array<juce::var> results;
+
+        for (int blockSize : { 64, 512 })
+        {
+            for (int oversamplingIndex = 0; oversamplingIndex < ParamEqAudioProcessor::NUM_OVERSAMPLING_FACTORS; ++oversamplingIndex)
+            {
+                ProcessConfig config;
+                config.blockSize = blockSize;
+                config.oversamplingIndex = oversamplingIndex;
+                results.add(benchProcessBlock(config, options));
+            }
+        }
+
+        return results;
+    }
+
+    // Fase linear em cada tamanho de kernel, ao lado da cascata IIR
+    juce::var runLinearPhaseSuite(const Options& options)
+    {
+        juce::Array<juce::var> results;
+
+        for (int blockSize : { 64, 512 })
+        {
+            for (int lengthIndex = -1; lengthIndex < LinearPhaseEngine::numKernelLengths; ++lengthIndex)
+            {
+                ProcessConfig config;
+                config.blockSize = blockSize;
+                config.linearPhaseLengthIndex = lengthIndex;
+                results.add(benchProcessBlock(config, options));
+            }
+        }
+
+        return results;
+    }
+
+    //==============================================================================
+    // Custo de processBlock com bandas automatizadas a cada bloco, comparado
+    // com as mesmas bandas estáticas. Inclui updateCachedCoefficients e as
+    // rampas de suavização.
+    juce::var benchAutomation(int blockSize, int automatedBands, const Options& options)
+    {
+        const ProcessConfig config { 48000.0, 2, blockSize, ParamEqAudioProcessor::NUM_BANDS, PEAK };
+        auto processor = createProcessor(config);
+
+        juce::AudioBuffer<float> buffer(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+
+        const int numBlocks = juce::jmax(64, static_cast<int>(config.sampleRate * options.secondsPerRun / blockSize));
+        std::vector<double> runs;
+
+        for (int run = 0; run < options.numRuns; ++run)
+        {
+            juce::int64 ticks = 0;
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                // Automação contínua: frequência e ganho mudam a cada bloco
+                for (int band = 0; band < automatedBands; ++band)
+                {
+                    const float phase = static_cast<float>((i + band * 7) % 64) / 64.0f;
+                    setBandParameter(*processor, BAND_FREQ, band, juce::mapToLog10(phase, 100.0f, 8000.0f));
+                    setBandParameter(*processor, BAND_GAIN, band, -9.0f + 18.0f * phase);
+                }
+
+                fillWithNoise(buffer);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                processor->processBlock(buffer, midi);
+                ticks += juce::Time::getHighResolutionTicks() - start;
+            }
+
+            runs.push_back(ticksToNs(ticks) / (static_cast<double>(numBlocks) * blockSize));
+        }
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("blockSize", blockSize);
+        result->setProperty("automatedBands", automatedBands);
+        result->setProperty("nsPerSample", median(runs));
+        return juce::var(result);
+    }
+
+    juce::var runAutomationSuite(const Options& options)
+    {
+        juce::Array<juce::var> results;
+
+        for (int blockSize : { 64, 512, 4096 })
+            for (int automatedBands : { 0, 1, ParamEqAudioProcessor::NUM_BANDS })
+                results.add(benchAutomation(blockSize, automatedBands, options));
+
+        return results;
+    }
+
+    // Custo isolado do projeto de coeficientes, por tipo de filtro e método
+    juce::var runCoefficientDesignSuite()
+    {
+        juce::Array<juce::var> results;
+        constexpr int numCalls = 200000;
+
+        for (auto method : { BILINEAR, MATCHED })
+        {
+            for (auto type : allFilterTypes)
+            {
+                double checksum = 0.0;
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                for (int i = 0; i < numCalls; ++i)
+                {
+                    const float freq = 20.0f + static_cast<float>(i % 1000) * 19.0f;
+                    checksum += CoefficientDesigner::design(type, 48000.0, freq, 0.7f, 3.0f, method).b0;
+                }
+
+                const double ns = ticksToNs(juce::Time::getHighResolutionTicks() - start) / numCalls;
+
+                auto* result = new juce::DynamicObject();
+                result->setProperty("filterType", ParamEqAudioProcessor::getFilterTypeName(type));
+                result->setProperty("design", method == MATCHED ? "matched" : "bilinear");
+                result->setProperty("nsPerDesign", ns);
+                result->setProperty("checksum", checksum); // impede que o laço seja eliminado
+                results.add(juce::var(result));
+            }
+        }
+
+        return results;
+    }
+
+    //==============================================================================
+    // Projeto casado contra bilinear em 1x e em 2x: erro máximo em dB em
+    // relação ao protótipo analógico entre 20 Hz e 20 kHz, e custo por amostra.
+    // O erro em 2x considera só a cascata, sem os filtros de meia banda
+    juce::var runMatchedDesignSuite(const Options& options)
+    {
+        struct TestBand { FilterType type; float freq, q, gainDb; };
+        const TestBand testBands[] = {
+            { PEAK, 1000.0f, 1.0f, 6.0f },   { PEAK, 8000.0f, 1.0f, 6.0f },   { PEAK, 14000.0f, 2.0f, -9.0f },
+            { LOW_SHELF, 200.0f, 0.7f, 6.0f }, { HIGH_SHELF, 10000.0f, 0.7f, 6.0f },
+            { LOW_PASS, 15000.0f, 0.7f, 0.0f }, { HIGH_PASS, 80.0f, 0.7f, 0.0f }
+        };
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int numPoints = 512;
+
+        auto maxErrorDb = [&](const TestBand& band, double designRate, DesignMethod method)
+        {
+            const auto coeffs = CoefficientDesigner::design(band.type, designRate, band.freq, band.q, band.gainDb, method);
+            const double gainFactor = std::pow(10.0, band.gainDb * 0.05);
+            double maxError = 0.0;
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const double freq = juce::mapToLog10(static_cast<double>(i) / (numPoints - 1), 20.0, 20000.0);
+                const double digital = CoefficientDesigner::getMagnitudeForFrequency(coeffs, freq, designRate);
+                const double analog = CoefficientDesigner::getAnalogMagnitude(band.type, freq, band.freq, band.q, gainFactor);
+                maxError = juce::jmax(maxError, std::abs(juce::Decibels::gainToDecibels(digital, -200.0)
+                                                         - juce::Decibels::gainToDecibels(analog, -200.0)));
+            }
+
+            return maxError;
+        };
+
+        juce::Array<juce::var> accuracy;
+        for (const auto& band : testBands)
+        {
+            auto* result = new juce::DynamicObject();
+            result->setProperty("filterType", ParamEqAudioProcessor::getFilterTypeName(band.type));
+            result->setProperty("freq", band.freq);
+            result->setProperty("bilinear1xMaxErrorDb", maxErrorDb(band, sampleRate, BILINEAR));
+            result->setProperty("matched1xMaxErrorDb", maxErrorDb(band, sampleRate, MATCHED));
+            result->setProperty("bilinear2xMaxErrorDb", maxErrorDb(band, sampleRate * 2.0, BILINEAR));
+            accuracy.add(juce::var(result));
+        }
+
+        juce::Array<juce::var> cpu;
+        for (int blockSize : { 64, 512 })
+        {
+            ProcessConfig bilinear, matched, oversampled;
+            bilinear.blockSize = matched.blockSize = oversampled.blockSize = blockSize;
+            matched.designMethod = MATCHED;
+            oversampled.oversamplingIndex = 1;
+
+            cpu.add(benchProcessBlock(bilinear, options));
+            cpu.add(benchProcessBlock(matched, options));
+            cpu.add(benchProcessBlock(oversampled, options));
+        }
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("accuracy", accuracy);
+        result->setProperty("cpu", cpu);
+        return juce::var(result);
+    }
+
+    //==============================================================================
+    // Bandas dinâmicas: 8 bandas estáticas contra 8 dinâmicas (detectores e
+    // atualização de ganho a cada 32 amostras) e o reprojeto só de ganho
+    // contra o completo
+    juce::var runDynamicsSuite(const Options& options)
+    {
+        juce::Array<juce::var> processBlock;
+
+        for (auto method : { BILINEAR, MATCHED })
+        {
+            for (int blockSize : { 64, 512 })
+            {
+                ProcessConfig config;
+                config.blockSize = blockSize;
+                config.designMethod = method;
+
+                const double staticNs = median(measureProcessBlock<float>(config, options));
+                config.dynamic = true;
+                const double dynamicNs = median(measureProcessBlock<float>(config, options));
+
+                auto* result = new juce::DynamicObject();
+                result->setProperty("blockSize", blockSize);
+                result->setProperty("design", method == MATCHED ? "matched" : "bilinear");
+                result->setProperty("staticNsPerSample", staticNs);
+                result->setProperty("dynamicNsPerSample", dynamicNs);
+                result->setProperty("ratio", staticNs > 0.0 ? dynamicNs / staticNs : 0.0);
+                processBlock.add(juce::var(result));
+            }
+        }
+
+        juce::Array<juce::var> gainUpdate;
+        constexpr int numCalls = 200000;
+
+        for (auto type : { PEAK, LOW_SHELF, HIGH_SHELF })
+        {
+            GainOnlyDesigner designer;
+            designer.prepare(type, 48000.0, 1000.0f, 0.7f);
+
+            double fullChecksum = 0.0, gainOnlyChecksum = 0.0;
+            auto start = juce::Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numCalls; ++i)
+                fullChecksum += CoefficientDesigner::design(type, 48000.0, 1000.0f, 0.7f, static_cast<float>(i % 240) * 0.1f - 12.0f).b0;
+
+            const double fullNs = ticksToNs(juce::Time::getHighResolutionTicks() - start) / numCalls;
+            start = juce::Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numCalls; ++i)
+                gainOnlyChecksum += designer.design(static_cast<float>(i % 240) * 0.1f - 12.0f).b0;
+
+            const double gainOnlyNs = ticksToNs(juce::Time::getHighResolutionTicks() - start) / numCalls;
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty("filterType", ParamEqAudioProcessor::getFilterTypeName(type));
+            result->setProperty("fullNsPerDesign", fullNs);
+            result->setProperty("gainOnlyNsPerDesign", gainOnlyNs);
+            result->setProperty("meanB0Difference", std::abs(fullChecksum - gainOnlyChecksum) / numCalls);
+            gainUpdate.add(juce::var(result));
+        }
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("processBlock", processBlock);
+        result->setProperty("gainUpdate", gainUpdate);
+        return juce::var(result);
+    }
+
+    //==============================================================================
+    // Custo de getEqCurve nas larguras típicas de tela, com uma banda ou
+    // todas as bandas mudando entre uma chamada e a próxima
+    juce::var runEqCurveSuite()
+    {
+        juce::Array<juce::var> results;
+        auto processor = createProcessor({});
+
+        for (int width : { 800, 1280, 1920, 2560, 3840 })
+        {
+            for (int changedBands : { 1, ParamEqAudioProcessor::NUM_BANDS })
+            {
+                constexpr int numCalls = 50;
+                float checksum = 0.0f;
+                juce::int64 ticks = 0;
+
+                for (int i = 0; i < numCalls; ++i)
+                {
+                    for (int band = 0; band < changedBands; ++band)
+                        setBandParameter(*processor, BAND_GAIN, band, i % 2 == 0 ? 6.0f : -6.0f);
+
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    checksum += processor->getEqCurve(width, 48000.0f)[static_cast<size_t>(width / 2)];
+                    ticks += juce::Time::getHighResolutionTicks() - start;
+                }
+
+                auto* result = new juce::DynamicObject();
+                result->setProperty("width", width);
+                result->setProperty("changedBands", changedBands);
+                result->setProperty("usPerCurve", ticksToNs(ticks) / numCalls / 1000.0);
+                result->setProperty("checksum", checksum);
+                results.add(juce::var(result));
+            }
+        }
+
+        return results;
+    }
+
+    //==============================================================================
+    // Salvar e restaurar o estado, por instância, no formato binário e no XML
+    // antigo. As instâncias alternam entre dois estados para que todos os
+    // parâmetros mudem a cada restauração
+    juce::var runStateSuite()
+    {
+        constexpr int numInstances = 100;
+        constexpr int numRounds = 10;
+
+        std::vector<std::unique_ptr<ParamEqAudioProcessor>> processors;
+        for (int i = 0; i < numInstances; ++i)
+            processors.push_back(std::make_unique<ParamEqAudioProcessor>());
+
+        // Dois estados de referência em cada formato, com os valores de origem
+        std::array<juce::MemoryBlock, 2> binaryStates, xmlStates;
+        std::array<std::vector<float>, 2> sourceValues;
+
+        for (int s = 0; s < 2; ++s)
+        {
+            configureBands(*processors.front(), s == 0 ? ParamEqAudioProcessor::NUM_BANDS : 3, s == 0 ? PEAK : LOW_SHELF);
+            processors.front()->getStateInformation(binaryStates[(size_t) s]);
+            processors.front()->getXmlStateInformation(xmlStates[(size_t) s]);
+            sourceValues[(size_t) s] = processors.front()->getParameterValues();
+        }
+
+        // Fora da medição: cada estado restaurado em uma instância nova deve
+        // reproduzir os valores de origem. Conta os parâmetros diferentes,
+        // para que um formato que grave valores padrão não passe despercebido
+        auto countMismatches = [&sourceValues](const std::array<juce::MemoryBlock, 2>& states)
+        {
+            int mismatches = 0;
+
+            for (size_t s = 0; s < states.size(); ++s)
+            {
+                ParamEqAudioProcessor restored;
+                const auto& expected = sourceValues[s];
+
+                if (! restored.restoreState(states[s].getData(), static_cast<int>(states[s].getSize())))
+                {
+                    mismatches += static_cast<int>(expected.size());
+                    continue;
+                }
+
+                const auto values = restored.getParameterValues();
+
+                // Os valores passam pela normalização do parâmetro na volta
+                for (size_t i = 0; i < expected.size(); ++i)
+                    if (std::abs(values[i] - expected[i]) > 1.0e-4f * juce::jmax(1.0f, std::abs(expected[i])))
+                        ++mismatches;
+            }
+
+            return mismatches;
+        };
+
+        auto measure = [&processors](auto&& operation)
+        {
+            juce::int64 ticks = 0;
+
+            for (int round = 0; round < numRounds; ++round)
+            {
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                for (size_t i = 0; i < processors.size(); ++i)
+                    operation(*processors[i], round);
+
+                ticks += juce::Time::getHighResolutionTicks() - start;
+            }
+
+            return ticksToNs(ticks) / (numInstances * numRounds) / 1000.0;
+        };
+
+        juce::MemoryBlock scratch;
+        bool allRestored = true;
+
+        const double binarySaveUs = measure([&scratch](ParamEqAudioProcessor& p, int) { p.getStateInformation(scratch); });
+        const double xmlSaveUs = measure([&scratch](ParamEqAudioProcessor& p, int) { p.getXmlStateInformation(scratch); });
+
+        const double binaryRestoreUs = measure([&](ParamEqAudioProcessor& p, int round)
+        {
+            const auto& state = binaryStates[(size_t) (round % 2)];
+            allRestored = p.restoreState(state.getData(), static_cast<int>(state.getSize())) && allRestored;
+        });
+
+        const double xmlRestoreUs = measure([&](ParamEqAudioProcessor& p, int round)
+        {
+            const auto& state = xmlStates[(size_t) (round % 2)];
+            allRestored = p.restoreState(state.getData(), static_cast<int>(state.getSize())) && allRestored;
+        });
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("instances", numInstances);
+        result->setProperty("parameters", processors.front()->getParameters().size());
+        result->setProperty("binaryBytes", static_cast<int>(binaryStates[0].getSize()));
+        result->setProperty("xmlBytes", static_cast<int>(xmlStates[0].getSize()));
+        result->setProperty("binarySaveUs", binarySaveUs);
+        result->setProperty("xmlSaveUs", xmlSaveUs);
+        result->setProperty("binaryRestoreUs", binaryRestoreUs);
+        result->setProperty("xmlRestoreUs", xmlRestoreUs);
+        result->setProperty("allRestored", allRestored);
+        result->setProperty("binaryMismatches", countMismatches(binaryStates));
+        result->setProperty("xmlMismatches", countMismatches(xmlStates));
+        return juce::var(result);
+    }
+
+    //==============================================================================
+    // Troca de programa a partir de um banco com milhares de presets e troca
+    // entre dois snapshots: custo na thread de mensagens e custo do bloco de
+    // áudio que aplica a troca (com o crossfade) comparado a um bloco comum
+    juce::var runSnapshotSuite(const Options& options)
+    {
+        constexpr int numPresets = 4096;
+        const ProcessConfig config;
+        auto processor = createProcessor(config);
+
+        // Banco temporário com presets variados
+        juce::StringArray names;
+        std::vector<float> values;
+        juce::Random random(4321);
+
+        for (int i = 0; i < numPresets; ++i)
+        {
+            configureBands(*processor, 1 + random.nextInt(ParamEqAudioProcessor::NUM_BANDS), allFilterTypes[(size_t) random.nextInt(3)]);
+            for (int band = 0; band < ParamEqAudioProcessor::NUM_BANDS; ++band)
+                setBandParameter(*processor, BAND_GAIN, band, random.nextFloat() * 24.0f - 12.0f);
+
+            const auto presetValues = processor->getParameterValues();
+            values.insert(values.end(), presetValues.begin(), presetValues.end());
+            names.add("Preset " + juce::String(i + 1));
+        }
+
+        juce::TemporaryFile bankFile(".peqbank");
+        PresetBank::write(bankFile.getFile(), processor->getStateParameterIDs(), names, values.data());
+        const bool bankLoaded = processor->loadPresetBank(bankFile.getFile());
+
+        juce::AudioBuffer<float> buffer(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+
+        // Mede a troca na thread de mensagens, o bloco que a aplica e um
+        // bloco comum logo depois
+        auto measureSwitches = [&](auto&& doSwitch)
+        {
+            const int numSwitches = options.numRuns * 200;
+            juce::int64 switchTicks = 0, switchBlockTicks = 0, steadyBlockTicks = 0;
+
+            for (int i = 0; i < numSwitches; ++i)
+            {
+                auto start = juce::Time::getHighResolutionTicks();
+                doSwitch(i);
+                switchTicks += juce::Time::getHighResolutionTicks() - start;
+
+                fillWithNoise(buffer);
+                start = juce::Time::getHighResolutionTicks();
+                processor->processBlock(buffer, midi);
+                switchBlockTicks += juce::Time::getHighResolutionTicks() - start;
+
+                fillWithNoise(buffer);
+                start = juce::Time::getHighResolutionTicks();
+                processor->processBlock(buffer, midi);
+                steadyBlockTicks += juce::Time::getHighResolutionTicks() - start;
+            }
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty("usPerSwitch", ticksToNs(switchTicks) / numSwitches / 1000.0);
+            result->setProperty("nsPerSampleSwitchBlock", ticksToNs(switchBlockTicks) / (static_cast<double>(numSwitches) * config.blockSize));
+            result->setProperty("nsPerSampleSteadyBlock", ticksToNs(steadyBlockTicks) / (static_cast<double>(numSwitches) * config.blockSize));
+            return juce::var(result);
+        };
+
+        auto programs = measureSwitches([&](int i) { processor->setCurrentProgram((i * 997) % numPresets); });
+
+        processor->setCurrentProgram(0);
+        processor->storeSnapshot(0);
+        processor->setCurrentProgram(1);
+        processor->storeSnapshot(1);
+        auto snapshots = measureSwitches([&](int i) { processor->recallSnapshot(i % 2); });
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("presets", numPresets);
+        result->setProperty("bankLoaded", bankLoaded);
+        result->setProperty("bankBytes", static_cast<juce::int64>(bankFile.getFile().getSize()));
+        result->setProperty("programChange", programs);
+        result->setProperty("snapshotRecall", snapshots);
+
+        processor->loadPresetBank({}); // libera o mapeamento antes de apagar o arquivo
+        return juce::var(result);
+    }
+
+    bool parseArguments(const juce::StringArray& args, Options& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const bool hasValue = i + 1 < args.size();
+
+            if (arg == "--full")
+                options.fullMatrix = true;
+            else if (arg == "--quick")
+            {
+                options.secondsPerRun = 0.1;
+                options.numRuns = 3;
+            }
+            else if (arg == "--out" && hasValue)
+                options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+            else
+                return false;
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    Options options;
+    if (! parseArguments(args, options))
+    {
+        std::cout << "Uso: ParamEqBench [--full] [--quick] [--out resultados.json]\n";
+        return 1;
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("version", JucePlugin_VersionString);
+    report->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("processBlock", runProcessBlockSuite(options));
+    report->setProperty("precision", runPrecisionSuite(options));
+    report->setProperty("oversampling", runOversamplingSuite(options));
+    report->setProperty("linearPhase", runLinearPhaseSuite(options));
+    report->setProperty("automation", runAutomationSuite(options));
+    report->setProperty("coefficientDesign", runCoefficientDesignSuite());
+    report->setProperty("dynamics", runDynamicsSuite(options));
+    report->setProperty("matchedDesign", runMatchedDesignSuite(options));
+    report->setProperty("eqCurve", runEqCurveSuite());
+    report->setProperty("state", runStateSuite());
+    report->setProperty("snapshots", runSnapshotSuite(options));
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (options.outputFile != juce::File())
+        options.outputFile.replaceWithText(json);
+    else
+        std::cout << json << "\n";
+
+    return 0;
+}
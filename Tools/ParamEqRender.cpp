@@ -0,0 +1,374 @@
+// ParamEQ - Parametric Equalizer Plugin
+// Copyright (C) 2025 Gustavo Mugnol Rocha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+// Renderização offline: aplica o ParamEQ a arquivos WAV/AIFF/FLAC sem DAW,
+// processando vários arquivos em paralelo (um processador por thread).
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_events/juce_events.h>
+#include <iostream>
+#include "../Source/PluginProcessor.h"
+
+namespace
+{
+    //==============================================================================
+    struct BandSetting
+    {
+        int band = 0;
+        int typeIndex = 0;
+        float freq = 1000.0f;
+        float gainDb = 0.0f;
+        float q = 1.0f;
+    };
+
+    struct RenderOptions
+    {
+        juce::Array<juce::File> inputs;
+        juce::File outputDir;
+        juce::File stateFile;
+        std::vector<BandSetting> bands;
+        int blockSize = 8192;
+        int numThreads = juce::SystemStats::getNumCpus();
+    };
+
+    struct RenderResult
+    {
+        bool ok = false;
+        double audioSeconds = 0.0;
+        juce::String error;
+    };
+
+    const char* const audioFileWildcard = "*.wav;*.aif;*.aiff;*.flac";
+
+    void printUsage()
+    {
+        std::cout << "Uso: ParamEqRender [opcoes] <arquivo ou pasta>...\n"
+                     "  --out <pasta>          pasta de saida (obrigatoria)\n"
+                     "  --state <arquivo>      estado salvo do plugin a aplicar\n"
+                     "  --band N:tipo:freq:ganho:q\n"
+                     "                         configura a banda N (1-8); tipo = peak, lowshelf,\n"
+                     "                         highshelf, lowpass ou highpass\n"
+                     "  --block <amostras>     tamanho do bloco de processamento (padrao 8192)\n"
+                     "  --threads <n>          numero de threads (padrao: numero de CPUs)\n";
+    }
+
+    int parseFilterType(const juce::String& name)
+    {
+        const auto lower = name.toLowerCase().removeCharacters(" _-");
+        const juce::StringArray names { "peak", "lowshelf", "highshelf", "lowpass", "highpass" };
+        return names.indexOf(lower);
+    }
+
+    bool parseBand(const juce::String& text, BandSetting& setting)
+    {
+        const auto tokens = juce::StringArray::fromTokens(text, ":", "");
+        if (tokens.size() != 5)
+            return false;
+
+        setting.band = tokens[0].getIntValue() - 1;
+        setting.typeIndex = parseFilterType(tokens[1]);
+        setting.freq = tokens[2].getFloatValue();
+        setting.gainDb = tokens[3].getFloatValue();
+        setting.q = tokens[4].getFloatValue();
+
+        return juce::isPositiveAndBelow(setting.band, ParamEqAudioProcessor::NUM_BANDS)
+            && setting.typeIndex >= 0 && setting.freq > 0.0f && setting.q > 0.0f;
+    }
+
+    bool parseArguments(const juce::StringArray& args, RenderOptions& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const bool hasValue = i + 1 < args.size();
+
+            if (arg == "--out" && hasValue)
+            {
+                options.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+            }
+            else if (arg == "--state" && hasValue)
+            {
+                options.stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+            }
+            else if (arg == "--band" && hasValue)
+            {
+                BandSetting setting;
+                if (! parseBand(args[++i], setting))
+                {
+                    std::cerr << "Banda invalida: " << args[i] << "\n";
+                    return false;
+                }
+                options.bands.push_back(setting);
+            }
+            else if (arg == "--block" && hasValue)
+            {
+                options.blockSize = juce::jlimit(16, 1 << 16, args[++i].getIntValue());
+            }
+            else if (arg == "--threads" && hasValue)
+            {
+                options.numThreads = juce::jmax(1, args[++i].getIntValue());
+            }
+            else if (arg.startsWith("--"))
+            {
+                std::cerr << "Opcao desconhecida: " << arg << "\n";
+                return false;
+            }
+            else
+            {
+                const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(arg);
+
+                if (file.isDirectory())
+                    options.inputs.addArray(file.findChildFiles(juce::File::findFiles, false, audioFileWildcard));
+                else if (file.existsAsFile())
+                    options.inputs.add(file);
+                else
+                    std::cerr << "Ignorando arquivo inexistente: " << arg << "\n";
+            }
+        }
+
+        return options.outputDir != juce::File() && ! options.inputs.isEmpty();
+    }
+
+    //==============================================================================
+    // Aplica o estado salvo e os ajustes de banda a um processador
+    bool configureProcessor(ParamEqAudioProcessor& processor, const RenderOptions& options)
+    {
+        if (options.stateFile != juce::File())
+        {
+            // Aceita o estado binário do plugin ou XML (texto ou binário da JUCE)
+            juce::MemoryBlock state;
+            if (! options.stateFile.loadFileAsData(state)
+                || ! processor.restoreState(state.getData(), static_cast<int>(state.getSize())))
+            {
+                std::cerr << "Estado invalido: " << options.stateFile.getFullPathName() << "\n";
+                return false;
+            }
+        }
+
+        auto setParameter = [&processor](BandParameter parameter, int band, float value)
+        {
+            if (auto* param = processor.parameters.getParameter(ParamEqAudioProcessor::getBandParameterID(parameter, band)))
+                param->setValueNotifyingHost(param->convertTo0to1(value));
+        };
+
+        for (const auto& setting : options.bands)
+        {
+            setParameter(BAND_TYPE, setting.band, static_cast<float>(setting.typeIndex));
+            setParameter(BAND_FREQ, setting.band, setting.freq);
+            setParameter(BAND_GAIN, setting.band, setting.gainDb);
+            setParameter(BAND_Q, setting.band, setting.q);
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // Cada worker tem seu próprio processador e pega o próximo arquivo da lista
+    class RenderWorker : public juce::Thread
+    {
+    public:
+        RenderWorker(std::unique_ptr<ParamEqAudioProcessor> p, const RenderOptions& o,
+                     std::atomic<int>& next, std::vector<RenderResult>& r)
+            : juce::Thread("ParamEq Render"), processor(std::move(p)), options(o), nextFile(next), results(r)
+        {
+            formatManager.registerBasicFormats();
+        }
+
+        ~RenderWorker() override
+        {
+            stopThread(-1);
+        }
+
+        void run() override
+        {
+            for (int index = nextFile++; index < options.inputs.size() && ! threadShouldExit(); index = nextFile++)
+                results[static_cast<size_t>(index)] = renderFile(options.inputs.getReference(index));
+        }
+
+    private:
+        RenderResult renderFile(const juce::File& input)
+        {
+            RenderResult result;
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+            if (reader == nullptr)
+            {
+                result.error = "formato nao suportado";
+                return result;
+            }
+
+            const int numChannels = static_cast<int>(reader->numChannels);
+            const double sampleRate = reader->sampleRate;
+            const int blockSize = options.blockSize;
+
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+            layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+            if (! processor->setBusesLayout(layout))
+            {
+                result.error = "numero de canais nao suportado (" + juce::String(numChannels) + ")";
+                return result;
+            }
+
+            const auto output = options.outputDir.getChildFile(input.getFileName());
+            if (output == input)
+            {
+                result.error = "a saida sobrescreveria a entrada";
+                return result;
+            }
+
+            auto* format = formatManager.findFormatForFileExtension(output.getFileExtension());
+            output.deleteFile();
+            std::unique_ptr<juce::FileOutputStream> stream(output.createOutputStream());
+
+            if (format == nullptr || stream == nullptr)
+            {
+                result.error = "nao foi possivel criar " + output.getFullPathName();
+                return result;
+            }
+
+            int bitDepth = static_cast<int>(reader->bitsPerSample);
+            if (! format->getPossibleBitDepths().contains(bitDepth))
+                bitDepth = 24;
+
+            std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+                                                                                    static_cast<unsigned int>(numChannels),
+                                                                                    bitDepth, reader->metadataValues, 0));
+            if (writer == nullptr)
+            {
+                result.error = "o formato de saida nao aceita esta configuracao";
+                return result;
+            }
+
+            stream.release(); // o writer passa a ser dono do stream
+
+            processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            juce::MidiBuffer midi;
+            const auto length = reader->lengthInSamples;
+
+            // Compensa a latência do processador: processa latency amostras a
+            // mais (silêncio após o fim do arquivo) e descarta as primeiras,
+            // para que a saída fique alinhada com a entrada
+            const juce::int64 latency = processor->getLatencySamples();
+
+            for (juce::int64 position = 0; position < length + latency && ! threadShouldExit(); position += blockSize)
+            {
+                const int numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, length + latency - position));
+                buffer.setSize(numChannels, numSamples, false, false, true);
+
+                // Leituras além do fim do arquivo preenchem com zeros
+                reader->read(&buffer, 0, numSamples, position, true, true);
+                processor->processBlock(buffer, midi);
+
+                const int skip = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, latency - position));
+                if (numSamples > skip)
+                    writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip);
+            }
+
+            processor->releaseResources();
+
+            result.ok = true;
+            result.audioSeconds = static_cast<double>(length) / sampleRate;
+            return result;
+        }
+
+        std::unique_ptr<ParamEqAudioProcessor> processor;
+        const RenderOptions& options;
+        std::atomic<int>& nextFile;
+        std::vector<RenderResult>& results;
+        juce::AudioFormatManager formatManager;
+    };
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    RenderOptions options;
+    if (! parseArguments(args, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (! options.outputDir.createDirectory())
+    {
+        std::cerr << "Nao foi possivel criar a pasta de saida\n";
+        return 1;
+    }
+
+    const int numWorkers = juce::jmin(options.numThreads, options.inputs.size());
+    std::vector<RenderResult> results(static_cast<size_t>(options.inputs.size()));
+    std::atomic<int> nextFile { 0 };
+
+    // Os processadores são criados na thread principal e entregues aos workers
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto processor = std::make_unique<ParamEqAudioProcessor>();
+        if (! configureProcessor(*processor, options))
+            return 1;
+
+        workers.push_back(std::make_unique<RenderWorker>(std::move(processor), options, nextFile, results));
+    }
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    int numRendered = 0;
+    double audioSeconds = 0.0;
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& result = results[i];
+        if (result.ok)
+        {
+            ++numRendered;
+            audioSeconds += result.audioSeconds;
+        }
+        else
+        {
+            std::cerr << "Falha em " << options.inputs.getReference(static_cast<int>(i)).getFullPathName()
+                      << ": " << result.error << "\n";
+        }
+    }
+
+    const double safeWallSeconds = juce::jmax(wallSeconds, 1.0e-9);
+
+    std::cout << "Arquivos processados: " << numRendered << " de " << options.inputs.size()
+              << " com " << numWorkers << " threads\n"
+              << "Tempo total: " << wallSeconds << " s\n"
+              << "Vazao: " << numRendered / safeWallSeconds << " arquivos/s\n"
+              << "Fator de tempo real: " << audioSeconds / safeWallSeconds << "x\n";
+
+    return numRendered == options.inputs.size() ? 0 : 1;
+}